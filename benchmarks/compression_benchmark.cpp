@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/compression.hpp"
+
+// Builds `bytes` of formatted log text shaped like the logger's output:
+// "[timestamp] message\n", with the message drawn from a weighted mix.
+enum class Mix { MarketData, OrderFlow, Mixed };
+
+static std::string make_corpus(Mix mix, size_t bytes) {
+    std::mt19937_64 rng(7);
+    std::string out;
+    out.reserve(bytes + 1024);
+    uint64_t ts = 1700000000000000000ull;
+    const char* symbols[] = {"AAPL", "MSFT", "ESZ4", "NQZ4", "EURUSD", "BTC-PERP"};
+    const char* sides[] = {"BUY", "SELL"};
+
+    while (out.size() < bytes) {
+        ts += 100 + rng() % 5000;
+        out += '[' + std::to_string(ts) + "] ";
+
+        // Mixed, out of 20: 10 market data, 7 orders, 2 FIX dumps, 1 multi-line stack trace
+        enum { MD, ORDER, FIX, TRACE } kind;
+        if (mix == Mix::MarketData) {
+            kind = MD;
+        } else if (mix == Mix::OrderFlow) {
+            kind = ORDER;
+        } else {
+            unsigned pick = rng() % 20;
+            kind = pick < 10 ? MD : pick < 17 ? ORDER : pick < 19 ? FIX : TRACE;
+        }
+        const char* sym = symbols[rng() % 6];
+        if (kind == MD) {
+            out += "MD ";
+            out += sym;
+            out += " bid=" + std::to_string(10000 + rng() % 500) + "." + std::to_string(rng() % 100);
+            out += " ask=" + std::to_string(10000 + rng() % 500) + "." + std::to_string(rng() % 100);
+            out += " sz=" + std::to_string(rng() % 5000);
+        } else if (kind == ORDER) {
+            out += "Order " + std::to_string(rng() % 100000000) + " ";
+            out += sides[rng() % 2];
+            out += ' ';
+            out += sym;
+            out += " px=" + std::to_string(100 + rng() % 50) + "." + std::to_string(rng() % 100);
+            out += " qty=" + std::to_string(100 * (1 + rng() % 20)) + " state=FILLED";
+        } else if (kind == FIX) {
+            out += "FIX 8=FIX.4.4|9=" + std::to_string(150 + rng() % 50) + "|35=8|49=EXCH|56=FIRM|34=" +
+                   std::to_string(rng() % 1000000) + "|52=20240101-09:30:00.123|37=" +
+                   std::to_string(rng()) + "|11=" + std::to_string(rng()) + "|17=" +
+                   std::to_string(rng()) + "|150=F|39=2|55=" + sym + "|54=1|38=300|44=101.25|10=" +
+                   std::to_string(rng() % 256) + "|";
+        } else {
+            out += "ERROR risk check failed\n    at RiskEngine::check(Order const&) risk.cpp:212\n"
+                   "    at OrderRouter::route(Order&) router.cpp:88\n"
+                   "    at Strategy::on_tick(Tick const&) strategy.cpp:431";
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+static void BM_Compress(benchmark::State& state) {
+    Mix mix = static_cast<Mix>(state.range(0));
+    size_t block_size = state.range(1);
+    std::string corpus = make_corpus(mix, block_size);
+    std::vector<char> out(lz4_compress_bound(corpus.size()));
+    size_t compressed = 0;
+
+    for (auto _ : state) {
+        compressed = lz4_compress_block(corpus.data(), corpus.size(), out.data());
+        benchmark::DoNotOptimize(compressed);
+    }
+
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+    state.counters["ratio"] = static_cast<double>(corpus.size()) / compressed;
+}
+BENCHMARK(BM_Compress)->ArgsProduct({{0, 1, 2}, {16 << 10, 64 << 10, 256 << 10}});
+
+static void BM_Decompress(benchmark::State& state) {
+    Mix mix = static_cast<Mix>(state.range(0));
+    std::string corpus = make_corpus(mix, 64 << 10);
+    std::vector<char> compressed(lz4_compress_bound(corpus.size()));
+    size_t n = lz4_compress_block(corpus.data(), corpus.size(), compressed.data());
+    std::string out(corpus.size(), '\0');
+
+    for (auto _ : state) {
+        long m = lz4_decompress_block(compressed.data(), n, &out[0], out.size());
+        benchmark::DoNotOptimize(m);
+    }
+
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+BENCHMARK(BM_Decompress)->Arg(0)->Arg(1)->Arg(2);
+
+// Full frame path as used by CompressedWriter (header + incompressible fallback).
+static void BM_EncodeFrame(benchmark::State& state) {
+    std::string corpus = make_corpus(Mix::Mixed, state.range(0));
+    std::string frame;
+
+    for (auto _ : state) {
+        frame.clear();
+        encode_frame(corpus.data(), corpus.size(), 1, 2, frame);
+        benchmark::DoNotOptimize(frame.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+    state.counters["ratio"] = static_cast<double>(corpus.size()) / frame.size();
+}
+BENCHMARK(BM_EncodeFrame)->Arg(16 << 10)->Arg(64 << 10)->Arg(256 << 10);
+
+BENCHMARK_MAIN();
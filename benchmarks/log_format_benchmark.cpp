@@ -0,0 +1,201 @@
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../include/log_format.hpp"
+#include "../include/number_format.hpp"
+
+// A ring entry plus the payload the consumer would resolve it to.
+struct Fill {
+    LogEntry entry;
+    char payload[128];
+};
+
+static std::vector<Fill> make_fills(size_t n) {
+    std::vector<Fill> fills(n);
+    for (size_t i = 0; i < n; i++) {
+        LogEntry& e = fills[i].entry;
+        e.timestamp = 1700000000000000000ull + i * 1000;
+        e.kind = EntryKind::KeyValue;
+        e.level = LogLevel::Info;
+        e.slab = SLAB_NONE;
+        e.length = encode_kv("fill", {{"order_id", uint64_t(90000000 + i)}, {"px", 101.25 + (i % 100) * 0.01},
+                                      {"qty", int64_t(100 * (1 + i % 10))}, {"venue", "XNAS"}},
+                             fills[i].payload, sizeof(fills[i].payload));
+    }
+    return fills;
+}
+
+// Producer-side cost of encoding typed fields (no stringification)
+static void BM_EncodeKv(benchmark::State& state) {
+    char payload[128];
+    uint64_t i = 0;
+    for (auto _ : state) {
+        size_t length = encode_kv("fill", {{"order_id", i}, {"px", 101.25}, {"qty", 300}, {"venue", "XNAS"}},
+                                  payload, sizeof(payload));
+        benchmark::DoNotOptimize(length);
+        i++;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeKv);
+
+// Consumer-side formatting per output format
+static void BM_Format(benchmark::State& state) {
+    auto entries = make_fills(1024);
+    LogFormatter formatter(static_cast<LogFormat>(state.range(0)));
+    std::string out;
+    size_t bytes = 0;
+
+    for (auto _ : state) {
+        out.clear();
+        for (const auto& e : entries) {
+            formatter.format(e.entry, e.payload, out);
+        }
+        bytes += out.size();
+    }
+    state.SetItemsProcessed(state.iterations() * entries.size());
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_Format)->Arg(static_cast<int>(LogFormat::Text))
+                   ->Arg(static_cast<int>(LogFormat::Json))
+                   ->Arg(static_cast<int>(LogFormat::Binary));
+
+// Downstream parsing: binary decoder vs. regex-scraping the text output
+static void BM_Parse_Binary(benchmark::State& state) {
+    auto entries = make_fills(1024);
+    LogFormatter formatter(LogFormat::Binary);
+    std::string out;
+    formatter.begin(out);
+    for (const auto& e : entries) formatter.format(e.entry, e.payload, out);
+
+    for (auto _ : state) {
+        BinaryLogDecoder decoder;
+        double sum = 0;
+        decoder.decode(out.data(), out.size(), [&](const DecodedRecord& r) { sum += r.fields[1].second.d; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(BM_Parse_Binary);
+
+static void BM_Parse_TextRegex(benchmark::State& state) {
+    auto entries = make_fills(1024);
+    LogFormatter formatter(LogFormat::Text);
+    std::vector<std::string> lines;
+    for (const auto& e : entries) {
+        std::string line;
+        formatter.format(e.entry, e.payload, line);
+        lines.push_back(line);
+    }
+    const std::regex pattern(R"(^\[(\d+)\] fill order_id=(\d+) px=([0-9.]+) qty=(\d+))");
+
+    for (auto _ : state) {
+        double sum = 0;
+        std::smatch m;
+        for (const auto& line : lines) {
+            if (std::regex_search(line, m, pattern)) sum += std::stod(m[3]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * entries.size());
+}
+BENCHMARK(BM_Parse_TextRegex);
+
+// Escaping throughput, bytes in per second on one core.
+// Args: EscapeMode, 0 = scalar scan / 1 = SIMD scan, one escapable byte every N bytes (0 = clean)
+static std::string make_escape_corpus(size_t size, size_t dirty_every) {
+    static const char words[] = "order accepted venue XNAS px 101.25 qty 300 client ABC-123 ";
+    std::string s;
+    for (size_t i = 0; s.size() < size; i++) {
+        s += words[i % (sizeof(words) - 1)];
+        if (dirty_every != 0 && s.size() % dirty_every == 0) {
+            s.back() = (s.size() / dirty_every) % 2 ? '\n' : '"';
+        }
+    }
+    return s;
+}
+
+static void BM_Escape(benchmark::State& state) {
+    EscapeMode mode = static_cast<EscapeMode>(state.range(0));
+    bool simd = state.range(1) != 0;
+    std::string corpus = make_escape_corpus(64 * 1024, state.range(2));
+    std::string out;
+    out.reserve(corpus.size() * 2);
+
+    for (auto _ : state) {
+        out.clear();
+        if (simd) {
+            append_escaped(out, corpus.data(), corpus.size(), mode);
+        } else {
+            // Same append loop, scalar scan
+            const char* p = corpus.data();
+            size_t n = corpus.size();
+            while (n > 0) {
+                size_t clean = escape_scan_scalar(p, n, mode);
+                out.append(p, clean);
+                if (clean == n) break;
+                append_escaped(out, p + clean, 1, mode);
+                p += clean + 1;
+                n -= clean + 1;
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+    state.SetLabel(simd ? escape_isa() : "scalar");
+}
+BENCHMARK(BM_Escape)->ArgsProduct({{static_cast<int>(EscapeMode::Text), static_cast<int>(EscapeMode::Json)},
+                                   {0, 1}, {0, 64}});
+
+// Number kernels vs. std::to_chars on the same inputs.
+// Arg: 0 = std::to_chars, 1 = number_format kernel
+static std::vector<double> make_prices(size_t n) {
+    std::mt19937_64 rng(1);
+    std::vector<double> v(n);
+    for (auto& x : v) x = static_cast<double>(rng() % 10000000) / 100.0;
+    return v;
+}
+
+static void BM_FormatTimestamp(benchmark::State& state) {
+    char buf[32];
+    uint64_t ts = 1700000000000000000ull;
+    for (auto _ : state) {
+        char* end = state.range(0) ? format_uint(buf, ts) : std::to_chars(buf, buf + sizeof(buf), ts).ptr;
+        benchmark::DoNotOptimize(end);
+        ts += 977;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatTimestamp)->Arg(0)->Arg(1);
+
+static void BM_FormatDouble(benchmark::State& state) {
+    auto prices = make_prices(1024);
+    char buf[32];
+    for (auto _ : state) {
+        for (double px : prices) {
+            char* end = state.range(0) ? format_double(buf, px) : std::to_chars(buf, buf + sizeof(buf), px).ptr;
+            benchmark::DoNotOptimize(end);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+BENCHMARK(BM_FormatDouble)->Arg(0)->Arg(1);
+
+static void BM_FormatPrice(benchmark::State& state) {
+    auto prices = make_prices(1024);
+    char buf[FIXED_CHARS_MAX];
+    for (auto _ : state) {
+        for (double px : prices) {
+            char* end = state.range(0) ? format_fixed(buf, px, 2)
+                                       : std::to_chars(buf, buf + sizeof(buf), px, std::chars_format::fixed, 2).ptr;
+            benchmark::DoNotOptimize(end);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+BENCHMARK(BM_FormatPrice)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -2,6 +2,7 @@
 #include <thread>
 #include <atomic>
 #include "../include/logger.hpp"
+#include "../include/log_backend.hpp"
 
 // Benchmark 1: Single-threaded log call latency
 static void BM_Logger_SingleLog(benchmark::State& state) {
@@ -89,10 +90,15 @@ static void BM_Logger_MultiThreaded(benchmark::State& state) {
 BENCHMARK(BM_Logger_MultiThreaded)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
 
 // Benchmark 5: Measure dropped logs under extreme load
+// (every iteration's logger shares one backend thread instead of spawning its own)
 static void BM_Logger_DropRate(benchmark::State& state) {
+    LogBackend backend;
+    LoggerOptions options;
+    options.backend = &backend;
+
     for (auto _ : state) {
         state.PauseTiming();
-        Logger logger("benchmark_drop.log");
+        Logger logger("benchmark_drop.log", options);
         state.ResumeTiming();
         
         // Flood the logger
@@ -111,4 +117,47 @@ static void BM_Logger_DropRate(benchmark::State& state) {
 }
 BENCHMARK(BM_Logger_DropRate);
 
+// Benchmark 6: Burst logging, direct publish vs. thread-local staging
+// (Arg = staging capacity; 0 publishes every entry on its own)
+static void BM_Logger_Burst(benchmark::State& state) {
+    constexpr int BURST_SIZE = 512;
+    LoggerOptions options;
+    options.staging_capacity = state.range(0);
+    options.idle_sleep = std::chrono::microseconds(50);
+    Logger logger("benchmark_burst.log", options);
+
+    for (auto _ : state) {
+        for (int i = 0; i < BURST_SIZE; i++) {
+            logger.log("Fixed test message");
+        }
+        logger.commit();
+
+        // Let the consumer catch up so bursts measure publish cost, not drops
+        state.PauseTiming();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * BURST_SIZE);
+    state.counters["dropped"] = logger.get_dropped_count();
+}
+BENCHMARK(BM_Logger_Burst)->Arg(0)->Arg(8)->Arg(32);
+
+// Benchmark 7: Front-end construction + destruction cost
+// (Arg 0 = own background thread, 1 = attached to a shared LogBackend)
+static void BM_Logger_Construct(benchmark::State& state) {
+    LogBackend backend;
+    LoggerOptions options;
+    if (state.range(0)) {
+        options.backend = &backend;
+    }
+
+    for (auto _ : state) {
+        Logger logger("benchmark_construct.log", options);
+        logger.log("Fixed test message");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Logger_Construct)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,458 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <sys/stat.h>
+#include "../include/logger.hpp"
+#include "../include/log_backend.hpp"
+
+// End-to-end logger throughput: producers replay a message corpus under a
+// burst pattern while the Logger writes to disk in each sink/writer mode.
+// The ring is single-producer, so every producer thread logs through its own
+// Logger and file: "thread" gives each one a consumer thread, "backend" drains
+// them all on one shared LogBackend, "manual" from one event loop.
+// Every run reports, from first log call until the files are closed:
+//   records_per_sec / bytes_per_sec   records delivered and bytes written
+//   consumer_cpu_pct                  CPU of everything but the producers
+//                                     (consumer, compression helper), % of one core
+//   drop_rate                         dropped / logged
+//   time_to_drain_ms                  last log call until every ring is empty
+//   close_ms                          rings empty until the files are closed
+// Results go to stdout (or --json FILE) as JSON; a summary table goes to stderr.
+//
+// usage: logger_e2e_benchmark [--profile orders|mixed|market_data] [--corpus FILE]
+//          [--records N] [--threads 1,2,4] [--pattern burst|steady]
+//          [--burst-size N] [--burst-gap-us N] [--rate N]
+//          [--formats text,json,binary] [--compression none,lz4]
+//          [--consumers thread,backend,manual] [--idle-sleep-us N]
+//          [--dir DIR] [--json FILE]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ---- Corpus ----
+
+struct CorpusMessage {
+    LogLevel level;
+    bool kv;
+    std::string text;           // text messages
+    uint64_t order_id;          // kv "fill" events
+    double px;
+    int64_t qty;
+    const char* venue;
+};
+
+struct CorpusProfile {
+    const char* name;
+    double kv_fraction;         // share of structured fills
+    double size_median;         // text message bytes, log-normal
+    double size_sigma;
+    double large_fraction;      // share of 2-16 KiB dumps (book snapshots, FIX messages)
+};
+
+const CorpusProfile PROFILES[] = {
+    {"orders", 0.7, 60, 0.4, 0.0},          // order lifecycle: fills + short status lines
+    {"mixed", 0.3, 90, 0.9, 0.01},          // service logs: wide sizes, rare large dumps
+    {"market_data", 0.95, 40, 0.3, 0.0},    // tick capture: almost all tiny kv events
+};
+
+const char* const VENUES[] = {"XNAS", "XNYS", "ARCX", "BATS", "IEXG"};
+const char* const WORDS[] = {"order", "accepted", "replaced", "cancel", "ack", "venue", "session",
+                             "risk", "check", "passed", "route", "latency", "us", "seq", "gap"};
+
+std::string make_text(std::mt19937_64& rng, size_t size, uint64_t id) {
+    std::string s = "order " + std::to_string(id) + " ";
+    while (s.size() < size) {
+        s += WORDS[rng() % (sizeof(WORDS) / sizeof(WORDS[0]))];
+        s += ' ';
+    }
+    s.resize(size);
+    return s;
+}
+
+std::string make_dump(std::mt19937_64& rng, size_t size) {
+    std::string s = "book snapshot:";
+    char level[32];
+    while (s.size() < size) {
+        std::snprintf(level, sizeof(level), " %.2fx%d", 100.0 + (rng() % 10000) / 100.0, int(rng() % 5000));
+        s += level;
+    }
+    s.resize(size);
+    return s;
+}
+
+std::vector<CorpusMessage> generate_corpus(const CorpusProfile& profile, size_t count) {
+    std::mt19937_64 rng(20240611);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::lognormal_distribution<double> text_size(std::log(profile.size_median), profile.size_sigma);
+    std::vector<CorpusMessage> corpus(count);
+
+    for (size_t i = 0; i < count; i++) {
+        CorpusMessage& m = corpus[i];
+        double r = unit(rng);
+        m.level = r < 0.9 ? LogLevel::Info : r < 0.98 ? LogLevel::Warn : LogLevel::Error;
+        m.kv = unit(rng) < profile.kv_fraction;
+        m.order_id = 90000000 + i;
+        m.px = 100.0 + static_cast<double>(rng() % 10000) / 100.0;
+        m.qty = 100 * static_cast<int64_t>(1 + rng() % 50);
+        m.venue = VENUES[rng() % (sizeof(VENUES) / sizeof(VENUES[0]))];
+        if (!m.kv) {
+            if (unit(rng) < profile.large_fraction) {
+                m.text = make_dump(rng, 2048 + rng() % (14 * 1024));
+            } else {
+                size_t size = static_cast<size_t>(std::clamp(text_size(rng), 8.0, 4096.0));
+                m.text = make_text(rng, size, m.order_id);
+            }
+        }
+    }
+    return corpus;
+}
+
+// One text message per non-empty line.
+std::vector<CorpusMessage> load_corpus(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("cannot open corpus " + path);
+    }
+    std::vector<CorpusMessage> corpus;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty()) {
+            CorpusMessage m{};
+            m.level = LogLevel::Info;
+            m.text = line;
+            corpus.push_back(std::move(m));
+        }
+    }
+    if (corpus.empty()) {
+        throw std::runtime_error("corpus " + path + " has no messages");
+    }
+    return corpus;
+}
+
+// ---- Configuration ----
+
+struct Options {
+    std::string profile = "mixed";
+    std::string corpus_file;
+    size_t records = 200000;                // per producer thread
+    std::vector<size_t> threads = {1, 2, 4};
+    std::string pattern = "burst";
+    size_t burst_size = 1000;
+    int64_t burst_gap_us = 200;
+    uint64_t rate = 0;                      // steady: records/s per thread, 0 = unpaced
+    std::vector<std::string> formats = {"text", "json", "binary"};
+    std::vector<std::string> compression = {"none", "lz4"};
+    std::vector<std::string> consumers = {"thread", "backend", "manual"};
+    int64_t idle_sleep_us = 1000;
+    std::string dir = ".";
+    std::string json_file;
+};
+
+struct Result {
+    std::string format, compression, consumer;
+    size_t threads;
+    uint64_t logged, dropped;
+    uint64_t bytes_written;
+    double seconds;
+    double consumer_cpu_pct;
+    double time_to_drain_ms;
+    double close_ms;
+};
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> parts;
+    std::stringstream in(s);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+double cpu_seconds(clockid_t clock) {
+    timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double seconds_between(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+// ---- One run ----
+
+void produce(Logger& logger, const std::vector<CorpusMessage>& corpus, size_t start, const Options& opt) {
+    size_t n = corpus.size();
+    auto interval = opt.rate ? std::chrono::nanoseconds(1000000000 / opt.rate) : std::chrono::nanoseconds(0);
+    auto next = Clock::now();
+
+    for (size_t i = 0; i < opt.records; i++) {
+        const CorpusMessage& m = corpus[(start + i) % n];
+        if (m.kv) {
+            logger.log_kv(m.level, "fill", {{"order_id", m.order_id}, {"px", m.px}, {"qty", m.qty}, {"venue", m.venue}});
+        } else {
+            logger.log(m.level, m.text);
+        }
+
+        if (opt.pattern == "burst") {
+            if ((i + 1) % opt.burst_size == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(opt.burst_gap_us));
+            }
+        } else if (opt.rate) {
+            next += interval;
+            while (Clock::now() < next) {}
+        }
+    }
+}
+
+Result run_one(const Options& opt, const std::vector<CorpusMessage>& corpus, const std::string& format,
+               const std::string& compression, const std::string& consumer, size_t threads) {
+    std::string base = opt.dir + "/e2e_" + format + "_" + compression + "_" + consumer;
+    std::vector<std::string> paths;
+    for (size_t t = 0; t < threads; t++) {
+        paths.push_back(base + "_" + std::to_string(t) + ".log");
+        std::remove(paths.back().c_str());
+    }
+
+    LoggerOptions options;
+    options.format = format == "json" ? LogFormat::Json : format == "binary" ? LogFormat::Binary : LogFormat::Text;
+    options.compression = compression == "lz4" ? Compression::LZ4 : Compression::None;
+    options.idle_sleep = std::chrono::microseconds(opt.idle_sleep_us);
+    options.manual_drain = consumer == "manual";
+
+    std::unique_ptr<LogBackend> backend;
+    if (consumer == "backend") {
+        backend.reset(new LogBackend(std::chrono::milliseconds(std::max<int64_t>(opt.idle_sleep_us / 1000, 1))));
+        options.backend = backend.get();
+    }
+
+    std::vector<std::unique_ptr<Logger>> loggers;
+    for (const std::string& path : paths) {
+        loggers.push_back(std::make_unique<Logger>(path, options));
+    }
+
+    // manual: an application event loop draining on eventfd readiness or a 1 ms tick
+    std::atomic<bool> reactor_stop{false};
+    std::thread reactor;
+    if (options.manual_drain) {
+        reactor = std::thread([&]() {
+            std::vector<pollfd> pfds;
+            for (auto& logger : loggers) {
+                pfds.push_back(pollfd{logger->notify_fd(), POLLIN, 0});
+            }
+            while (!reactor_stop.load(std::memory_order_acquire)) {
+                ::poll(pfds.data(), pfds.size(), 1);
+                for (auto& logger : loggers) {
+                    logger->drain(1024);
+                }
+            }
+        });
+    }
+
+    std::vector<double> producer_cpu(threads, 0.0);
+    double process_cpu_start = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID);
+    double main_cpu_start = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+    auto start = Clock::now();
+
+    std::vector<std::thread> producers;
+    for (size_t t = 0; t < threads; t++) {
+        producers.emplace_back([&, t]() {
+            double cpu = cpu_seconds(CLOCK_THREAD_CPUTIME_ID);
+            produce(*loggers[t], corpus, t * (corpus.size() / threads), opt);
+            producer_cpu[t] = cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - cpu;
+        });
+    }
+    for (auto& p : producers) {
+        p.join();
+    }
+    auto produced = Clock::now();
+
+    for (auto& logger : loggers) {
+        while (logger->get_queue_depth() > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    auto drained = Clock::now();
+    double main_cpu = cpu_seconds(CLOCK_THREAD_CPUTIME_ID) - main_cpu_start;
+
+    uint64_t dropped = 0;
+    for (auto& logger : loggers) {
+        dropped += logger->get_dropped_count();
+    }
+    reactor_stop.store(true, std::memory_order_release);
+    if (reactor.joinable()) {
+        reactor.join();
+    }
+    loggers.clear();            // final drain, flush, compression, close
+    backend.reset();
+    auto closed = Clock::now();
+    double process_cpu = cpu_seconds(CLOCK_PROCESS_CPUTIME_ID) - process_cpu_start;
+
+    uint64_t bytes_written = 0;
+    for (const std::string& path : paths) {
+        struct stat st {};
+        ::stat(path.c_str(), &st);
+        bytes_written += static_cast<uint64_t>(st.st_size);
+        std::remove(path.c_str());
+    }
+
+    Result r;
+    r.format = format;
+    r.compression = compression;
+    r.consumer = consumer;
+    r.threads = threads;
+    r.logged = opt.records * threads;
+    r.dropped = dropped;
+    r.bytes_written = bytes_written;
+    r.seconds = seconds_between(start, closed);
+    double producers_cpu = 0;
+    for (double c : producer_cpu) producers_cpu += c;
+    r.consumer_cpu_pct = std::max(0.0, process_cpu - producers_cpu - main_cpu) / r.seconds * 100.0;
+    r.time_to_drain_ms = seconds_between(produced, drained) * 1e3;
+    r.close_ms = seconds_between(drained, closed) * 1e3;
+    return r;
+}
+
+// ---- Output ----
+
+void write_json(std::ostream& out, const Options& opt, const std::string& corpus_name, size_t corpus_size,
+                double mean_bytes, const std::vector<Result>& results) {
+    out << "{\n  \"benchmark\": \"logger_e2e\",\n";
+    std::string name;
+    append_escaped(name, corpus_name.data(), corpus_name.size(), EscapeMode::Json);
+    out << "  \"corpus\": {\"name\": \"" << name << "\", \"messages\": " << corpus_size
+        << ", \"mean_text_bytes\": " << mean_bytes << "},\n";
+    out << "  \"workload\": {\"records_per_thread\": " << opt.records << ", \"pattern\": \"" << opt.pattern
+        << "\", \"burst_size\": " << opt.burst_size << ", \"burst_gap_us\": " << opt.burst_gap_us
+        << ", \"rate\": " << opt.rate << ", \"idle_sleep_us\": " << opt.idle_sleep_us << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        uint64_t delivered = r.logged - r.dropped;
+        out << "    {\"format\": \"" << r.format << "\", \"compression\": \"" << r.compression
+            << "\", \"consumer\": \"" << r.consumer << "\", \"threads\": " << r.threads
+            << ", \"records\": " << r.logged << ", \"dropped\": " << r.dropped
+            << ", \"drop_rate\": " << static_cast<double>(r.dropped) / r.logged
+            << ", \"bytes_written\": " << r.bytes_written << ", \"seconds\": " << r.seconds
+            << ", \"records_per_sec\": " << delivered / r.seconds
+            << ", \"bytes_per_sec\": " << r.bytes_written / r.seconds
+            << ", \"consumer_cpu_pct\": " << r.consumer_cpu_pct
+            << ", \"time_to_drain_ms\": " << r.time_to_drain_ms << ", \"close_ms\": " << r.close_ms << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+void print_row(const Result& r) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-7s %-5s %-8s %3zu %12.0f %10.1f %7.1f %8.3f%% %9.2f %9.2f\n",
+                  r.format.c_str(), r.compression.c_str(), r.consumer.c_str(), r.threads,
+                  (r.logged - r.dropped) / r.seconds, r.bytes_written / r.seconds / 1e6, r.consumer_cpu_pct,
+                  100.0 * r.dropped / r.logged, r.time_to_drain_ms, r.close_ms);
+    std::cerr << line;
+}
+
+int usage() {
+    std::cerr << "usage: logger_e2e_benchmark [--profile orders|mixed|market_data] [--corpus FILE]\n"
+                 "         [--records N] [--threads 1,2,4] [--pattern burst|steady]\n"
+                 "         [--burst-size N] [--burst-gap-us N] [--rate N]\n"
+                 "         [--formats text,json,binary] [--compression none,lz4]\n"
+                 "         [--consumers thread,backend,manual] [--idle-sleep-us N]\n"
+                 "         [--dir DIR] [--json FILE]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return usage();
+        }
+        std::string value = argv[++i];
+        if (arg == "--profile") opt.profile = value;
+        else if (arg == "--corpus") opt.corpus_file = value;
+        else if (arg == "--records") opt.records = std::stoull(value);
+        else if (arg == "--threads") {
+            opt.threads.clear();
+            for (const auto& t : split(value)) opt.threads.push_back(std::stoull(t));
+        }
+        else if (arg == "--pattern") opt.pattern = value;
+        else if (arg == "--burst-size") opt.burst_size = std::max<size_t>(std::stoull(value), 1);
+        else if (arg == "--burst-gap-us") opt.burst_gap_us = std::stoll(value);
+        else if (arg == "--rate") opt.rate = std::stoull(value);
+        else if (arg == "--formats") opt.formats = split(value);
+        else if (arg == "--compression") opt.compression = split(value);
+        else if (arg == "--consumers") opt.consumers = split(value);
+        else if (arg == "--idle-sleep-us") opt.idle_sleep_us = std::stoll(value);
+        else if (arg == "--dir") opt.dir = value;
+        else if (arg == "--json") opt.json_file = value;
+        else return usage();
+    }
+    if (opt.pattern != "burst" && opt.pattern != "steady") {
+        return usage();
+    }
+
+    std::vector<CorpusMessage> corpus;
+    std::string corpus_name;
+    if (!opt.corpus_file.empty()) {
+        corpus = load_corpus(opt.corpus_file);
+        corpus_name = opt.corpus_file;
+    } else {
+        auto profile = std::find_if(std::begin(PROFILES), std::end(PROFILES),
+                                    [&](const CorpusProfile& p) { return opt.profile == p.name; });
+        if (profile == std::end(PROFILES)) {
+            return usage();
+        }
+        corpus = generate_corpus(*profile, 8192);
+        corpus_name = profile->name;
+    }
+    size_t text_count = 0, text_bytes = 0;
+    for (const auto& m : corpus) {
+        if (!m.kv) {
+            text_count++;
+            text_bytes += m.text.size();
+        }
+    }
+    double mean_bytes = text_count ? static_cast<double>(text_bytes) / text_count : 0.0;
+
+    std::cerr << "corpus " << corpus_name << ": " << corpus.size() << " messages, mean text "
+              << static_cast<size_t>(mean_bytes) << " B; " << opt.records << " records/thread, " << opt.pattern << "\n";
+    std::cerr << "format  comp  consumer thr    records/s       MB/s   cpu%    drop%  drain_ms  close_ms\n";
+
+    std::vector<Result> results;
+    for (const auto& format : opt.formats) {
+        for (const auto& compression : opt.compression) {
+            for (const auto& consumer : opt.consumers) {
+                for (size_t threads : opt.threads) {
+                    results.push_back(run_one(opt, corpus, format, compression, consumer, threads));
+                    print_row(results.back());
+                }
+            }
+        }
+    }
+
+    if (opt.json_file.empty()) {
+        write_json(std::cout, opt, corpus_name, corpus.size(), mean_bytes, results);
+    } else {
+        std::ofstream out(opt.json_file);
+        write_json(out, opt, corpus_name, corpus.size(), mean_bytes, results);
+    }
+    return 0;
+}
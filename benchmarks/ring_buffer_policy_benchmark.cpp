@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include "../include/ring_buffer.hpp"
+
+// Every RingBuffer policy combination (index width x padding x memory
+// ordering x index caching), each measured by the same three benchmarks.
+// Filter with e.g. --benchmark_filter='SPSC/.*/cached'.
+
+constexpr size_t RING_CAPACITY = 1024;
+constexpr int SPSC_ITEMS = 10000;
+
+// Single thread, ring kept near full: cost of the full-check on push
+template <typename Ring>
+static void BM_Push(benchmark::State& state) {
+    auto rb = std::make_unique<Ring>();
+    int value = 42;
+
+    for (auto _ : state) {
+        if (!rb->try_push(value)) {
+            int dummy;
+            rb->try_pop(dummy);
+            rb->try_push(value);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Single thread, push then pop: uncontended round trip
+template <typename Ring>
+static void BM_PushPop(benchmark::State& state) {
+    auto rb = std::make_unique<Ring>();
+    int value = 42;
+    int result = 0;
+
+    for (auto _ : state) {
+        rb->try_push(value);
+        rb->try_pop(result);
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Producer and consumer on separate cores. The consumer lives for the whole
+// run, so an iteration measures 10000 items crossing cores, not thread start-up.
+template <typename Ring>
+static void BM_SPSC(benchmark::State& state) {
+    auto rb = std::make_unique<Ring>();
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> popped{0};
+
+    std::thread consumer([&]() {
+        int value;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (rb->try_pop(value)) {
+                benchmark::DoNotOptimize(value);
+                popped.store(popped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        }
+    });
+
+    int64_t pushed = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < SPSC_ITEMS; i++) {
+            while (!rb->try_push(i)) {}
+        }
+        pushed += SPSC_ITEMS;
+        while (popped.load(std::memory_order_acquire) < pushed) {}
+    }
+
+    stop = true;
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * SPSC_ITEMS);
+}
+
+template <typename Index, size_t Padding, typename Ordering, bool Cache>
+static void register_combination() {
+    using Ring = RingBuffer<int, RING_CAPACITY, Index, Padding, Ordering, Cache>;
+    std::string name = std::string(sizeof(Index) == 4 ? "u32" : "u64")
+        + "/pad" + std::to_string(Padding)
+        + "/" + Ordering::name
+        + (Cache ? "/cached" : "/uncached");
+
+    benchmark::RegisterBenchmark(("Push/" + name).c_str(), BM_Push<Ring>);
+    benchmark::RegisterBenchmark(("PushPop/" + name).c_str(), BM_PushPop<Ring>);
+    benchmark::RegisterBenchmark(("SPSC/" + name).c_str(), BM_SPSC<Ring>)->UseRealTime();
+}
+
+template <typename Index, size_t Padding, typename Ordering>
+static void register_caching() {
+    register_combination<Index, Padding, Ordering, false>();
+    register_combination<Index, Padding, Ordering, true>();
+}
+
+template <typename Index, size_t Padding>
+static void register_orderings() {
+    register_caching<Index, Padding, AcquireRelease>();
+    register_caching<Index, Padding, SequentiallyConsistent>();
+}
+
+template <typename Index>
+static void register_paddings() {
+    register_orderings<Index, 64>();
+    register_orderings<Index, 128>();
+}
+
+int main(int argc, char** argv) {
+    register_paddings<uint32_t>();
+    register_paddings<uint64_t>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "log_index.hpp"
+
+// Compresses formatted batches into independent frames on a helper thread so
+// the logger's consumer can go straight back to draining the ring.
+class CompressedWriter {
+    public:
+        // `out` must outlive the writer. At most `max_pending` blocks queue up
+        // before submit() blocks (disk back-pressure). With an `index`, every
+        // frame start is recorded; `file_offset` is where the first frame lands.
+        CompressedWriter(std::ofstream& out, size_t max_pending = 4,
+                         LogIndexWriter* index = nullptr, uint64_t file_offset = 0);
+        ~CompressedWriter();
+
+        CompressedWriter(const CompressedWriter&) = delete;
+        CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+        void submit(std::string&& block, uint64_t first_timestamp, uint64_t last_timestamp);
+        // Blocks until every submitted block is on disk.
+        void flush();
+
+        uint64_t get_raw_bytes() const {return raw_bytes_;}
+        uint64_t get_compressed_bytes() const {return compressed_bytes_;}
+
+    private:
+        struct Block {
+            std::string data;
+            uint64_t first_timestamp;
+            uint64_t last_timestamp;
+        };
+
+        std::ofstream& out_;
+        size_t max_pending_;
+        LogIndexWriter* index_;
+        uint64_t file_offset_;   // helper thread only
+        std::mutex mutex_;
+        std::condition_variable work_ready_;
+        std::condition_variable work_done_;
+        std::deque<Block> queue_;
+        bool busy_;
+        bool shutdown_;
+        std::thread thread_;
+
+        // Written by the helper thread, read after flush().
+        uint64_t raw_bytes_;
+        uint64_t compressed_bytes_;
+
+        void worker();
+};
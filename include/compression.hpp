@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+
+// LZ4 block format, implemented in-tree so the logger has no external
+// dependencies. Blocks are readable by LZ4_decompress_safe().
+size_t lz4_compress_bound(size_t src_size);
+// `dst` must hold lz4_compress_bound(src_size) bytes. Returns bytes written.
+size_t lz4_compress_block(const char* src, size_t src_size, char* dst);
+// Returns bytes written to `dst`, or -1 on malformed input or if `dst` is too small.
+long lz4_decompress_block(const char* src, size_t src_size, char* dst, size_t dst_capacity);
+
+// A compressed log file is a plain sequence of independent frames, so a reader
+// can start decoding at any frame boundary. Fields are host (little) endian.
+struct FrameHeader {
+    uint32_t magic;
+    uint32_t flags;
+    uint32_t raw_size;
+    uint32_t stored_size;
+    uint64_t first_timestamp;   // oldest record in the frame
+    uint64_t last_timestamp;    // newest record in the frame
+};
+static_assert(sizeof(FrameHeader) == 32, "FrameHeader is an on-disk layout");
+
+constexpr uint32_t FRAME_MAGIC = 0x315A4C41;   // "ALZ1"
+constexpr uint32_t FRAME_STORED = 1;           // payload kept raw (block did not compress)
+
+// Appends one frame holding `raw` to `out`.
+void encode_frame(const char* raw, size_t raw_size, uint64_t first_timestamp,
+                  uint64_t last_timestamp, std::string& out);
+// Reads the next frame; returns false at end of stream, throws std::runtime_error on corruption.
+bool read_frame(std::istream& in, FrameHeader& header, std::string& raw);
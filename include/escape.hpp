@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// How string bytes are written to a sink.
+enum class EscapeMode : uint8_t {
+    Raw,    // verbatim (an embedded newline splits the record)
+    Text,   // control bytes as \n \r \t \xHH, backslash doubled; one record per line
+    Json,   // RFC 8259 string body: quote, backslash and control bytes escaped
+};
+
+// Index of the first byte in [s, s + n) that `mode` must escape, or n if the
+// run is clean. Scans 32 (AVX2) or 16 (SSE2, NEON) bytes per step, whichever
+// the build targets; Raw never escapes.
+size_t escape_scan(const char* s, size_t n, EscapeMode mode);
+
+// Byte-at-a-time reference for escape_scan.
+size_t escape_scan_scalar(const char* s, size_t n, EscapeMode mode);
+
+// Appends [s, s + n) escaped for `mode` (no surrounding quotes). Clean runs
+// are copied with one append each.
+void append_escaped(std::string& out, const char* s, size_t n, EscapeMode mode);
+
+// "avx2", "sse2", "neon" or "scalar": the escape_scan this build uses.
+const char* escape_isa();
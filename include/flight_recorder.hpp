@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "log_format.hpp"
+
+// Flight-recorder entries carry their payload with them (never a pool slab),
+// truncated to this many bytes.
+constexpr size_t FLIGHT_RECORD_PAYLOAD = 512;
+
+struct FlightRecord {
+    LogEntry entry;
+    char payload[FLIGHT_RECORD_PAYLOAD];
+};
+
+// Per-thread history of recent low-severity entries. The owning thread
+// overwrites the oldest slot on wrap and never waits; the consumer copies the
+// slots out when a dump is triggered. Each slot carries a sequence number
+// (odd while being written) so a reader can tell a torn or overwritten copy
+// from a good one and skip it.
+class FlightRecorder {
+    public:
+        // Capacity is rounded up to a power of two.
+        explicit FlightRecorder(size_t capacity)
+            : mask_(round_up(capacity) - 1), slots_(new Slot[mask_ + 1]), head_(0), snapshot_from_(0) {}
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        // Owning thread only: fill the returned record, then call end_write().
+        FlightRecord& begin_write() {
+            uint64_t i = head_.load(std::memory_order_relaxed);
+            Slot& slot = slots_[i & mask_];
+            slot.seq.store(2 * i + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            return slot.record;
+        }
+
+        void end_write() {
+            uint64_t i = head_.load(std::memory_order_relaxed);
+            slots_[i & mask_].seq.store(2 * i + 2, std::memory_order_release);
+            head_.store(i + 1, std::memory_order_release);
+        }
+
+        // Consumer only: appends the entries written since the previous
+        // snapshot that are still intact, oldest first. Returns how many were
+        // lost to wrap-around or a concurrent overwrite.
+        size_t snapshot(std::vector<FlightRecord>& out) {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            uint64_t capacity = mask_ + 1;
+            uint64_t from = head > capacity ? head - capacity : 0;
+            size_t lost = 0;
+            if (from > snapshot_from_) {
+                lost += from - snapshot_from_;
+            } else {
+                from = snapshot_from_;
+            }
+
+            FlightRecord copy;
+            for (uint64_t i = from; i < head; i++) {
+                const Slot& slot = slots_[i & mask_];
+                uint64_t expected = 2 * i + 2;
+                if (slot.seq.load(std::memory_order_acquire) != expected) {
+                    lost++;
+                    continue;
+                }
+                std::memcpy(&copy, &slot.record, sizeof(copy));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != expected) {
+                    lost++;
+                    continue;
+                }
+                out.push_back(copy);
+            }
+            snapshot_from_ = head;
+            return lost;
+        }
+
+        size_t capacity() const {return mask_ + 1;}
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> seq{0};
+            FlightRecord record;
+        };
+
+        static size_t round_up(size_t n) {
+            size_t p = 1;
+            while (p < n) {
+                p <<= 1;
+            }
+            return p;
+        }
+
+        const size_t mask_;
+        std::unique_ptr<Slot[]> slots_;
+        alignas(64) std::atomic<uint64_t> head_;    // next index to write
+        alignas(64) uint64_t snapshot_from_;        // consumer only
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "slab_pool.hpp"
+
+class Logger;
+
+// One consumer thread shared by many Logger front-ends (LoggerOptions::backend).
+// Front-ends spawn no thread of their own; the backend visits them
+// round-robin, writing at most batch_size entries from each per pass so a
+// busy logger cannot starve the others. When every ring is empty it sleeps
+// in epoll on the front-ends' notify eventfds, so a ring reaching its
+// notify_threshold wakes it early. Front-ends also share the backend's
+// slab pool.
+//
+// Destroy every Logger attached to a backend before the backend itself.
+class LogBackend {
+    public:
+        // idle_sleep has millisecond granularity (epoll timeout).
+        explicit LogBackend(std::chrono::milliseconds idle_sleep = std::chrono::milliseconds(100),
+                            size_t batch_size = 256);
+        ~LogBackend();
+
+        LogBackend(const LogBackend&) = delete;
+        LogBackend& operator=(const LogBackend&) = delete;
+
+        size_t logger_count();
+
+    private:
+        friend class Logger;
+
+        void attach(Logger* logger, int notify_fd);
+        // Returns once the backend thread is no longer touching `logger`.
+        void detach(Logger* logger, int notify_fd);
+        SlabPool& pool() {return *pool_;}
+        void run();
+
+        std::chrono::milliseconds idle_sleep_;
+        size_t batch_size_;
+        std::unique_ptr<SlabPool> pool_;
+        int epoll_fd_;
+
+        std::mutex mutex_;                // held for a whole pass over loggers_
+        std::vector<Logger*> loggers_;
+        size_t next_start_;               // rotates so no logger is always first
+
+        std::atomic<bool> shutdown_flag_;
+        std::thread thread_;
+};
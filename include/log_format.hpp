@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "escape.hpp"
+
+enum class LogLevel : uint8_t { Trace, Debug, Info, Warn, Error, Fatal };
+
+// "TRACE", "DEBUG", ... as written to every sink.
+const char* level_name(LogLevel level);
+
+enum class EntryKind : uint8_t {
+    Text,
+    KeyValue,   // payload holds an encoded event + typed fields (see encode_kv)
+};
+
+constexpr size_t LOG_INLINE_CAPACITY = 46;
+constexpr size_t LOG_MAX_PAYLOAD = 65535;      // longest payload a record can carry
+constexpr uint32_t SLAB_NONE = 0xffffffff;
+
+// One ring slot, one cache line. Payloads up to LOG_INLINE_CAPACITY bytes
+// are stored inline; larger ones live in a SlabPool slab named by `slab`.
+// Trivially copyable so it can be pushed by value.
+struct alignas(64) LogEntry {
+    uint64_t timestamp;
+    uint32_t length;
+    uint32_t slab;          // SLAB_NONE when the payload is inline
+    EntryKind kind;
+    LogLevel level;
+    char inline_data[LOG_INLINE_CAPACITY];
+};
+static_assert(sizeof(LogEntry) == 64, "LogEntry must fill exactly one cache line");
+
+enum class LogFormat {
+    Text,       // "[ts] message" / "[ts] event key=value ...", "[ts] LEVEL ..." unless INFO
+    Json,       // one JSON object per line
+    Binary,     // schema-grouped binary records, see BinaryLogDecoder
+};
+
+enum class KvType : uint8_t { Int = 1, UInt, Double, Bool, String };
+
+// A typed field for Logger::log_kv. Keys and string values are copied into the
+// ring entry, so they only need to live for the duration of the call.
+struct KvField {
+    const char* key;
+    KvType type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        bool b;
+    };
+    const char* str = nullptr;
+    size_t str_len = 0;
+
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, int>::type = 0>
+    KvField(const char* k, T v) : key(k), type(KvType::Int), i(v) {}
+    template <typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                                  !std::is_same<T, bool>::value, int>::type = 0>
+    KvField(const char* k, T v) : key(k), type(KvType::UInt), u(v) {}
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    KvField(const char* k, T v) : key(k), type(KvType::Double), d(v) {}
+    KvField(const char* k, bool v) : key(k), type(KvType::Bool), b(v) {}
+    KvField(const char* k, const char* v) : key(k), type(KvType::String), u(0), str(v), str_len(std::char_traits<char>::length(v)) {}
+    KvField(const char* k, const std::string& v) : key(k), type(KvType::String), u(0), str(v.data()), str_len(v.size()) {}
+};
+
+// Bytes encode_kv needs to store every field.
+size_t kv_encoded_size(const char* event, std::initializer_list<KvField> fields);
+// Encodes an event and its fields into `out` (producer side, no allocation).
+// Fields that do not fit in `capacity` are dropped; returns bytes used.
+size_t encode_kv(const char* event, std::initializer_list<KvField> fields, char* out, size_t capacity);
+
+// Turns ring entries into output bytes. Owned by the consumer thread; the
+// binary encoder keeps a schema table so each event layout is described once.
+// `text_escape` applies to message, event, key and string bytes in Text
+// output; Json output is always JSON-escaped and Binary is always verbatim.
+// `double_precision` (0-9) prints Text/Json doubles with that many decimals;
+// negative prints the shortest round-trip form.
+class LogFormatter {
+    public:
+        explicit LogFormatter(LogFormat format, EscapeMode text_escape = EscapeMode::Raw,
+                              int double_precision = -1);
+
+        // Appends whatever a fresh output stream needs (the binary magic).
+        void begin(std::string& out);
+        // `payload` holds entry.length bytes (inline_data or the entry's slab).
+        void format(const LogEntry& entry, const char* payload, std::string& out);
+
+    private:
+        LogFormat format_;
+        EscapeMode text_escape_;
+        int double_precision_;
+        std::unordered_map<std::string, uint16_t> schemas_;
+        std::string signature_;
+
+        void format_text(const LogEntry& entry, const char* payload, std::string& out);
+        void format_json(const LogEntry& entry, const char* payload, std::string& out);
+        void format_binary(const LogEntry& entry, const char* payload, std::string& out);
+};
+
+struct KvValue {
+    KvType type;
+    int64_t i = 0;
+    uint64_t u = 0;
+    double d = 0.0;
+    bool b = false;
+    std::string s;
+};
+
+struct DecodedRecord {
+    uint64_t timestamp = 0;
+    LogLevel level = LogLevel::Info;
+    bool is_text = false;
+    std::string text;       // message for text records, event name otherwise
+    std::vector<std::pair<std::string, KvValue>> fields;
+};
+
+constexpr char BINARY_LOG_MAGIC[4] = {'A', 'L', 'B', '2'};
+
+// Reads the LogFormat::Binary stream back for downstream tools.
+class BinaryLogDecoder {
+    public:
+        // Decodes every complete record in [data, data + size); returns bytes
+        // consumed. Throws std::runtime_error on malformed input.
+        size_t decode(const char* data, size_t size, const std::function<void(const DecodedRecord&)>& on_record);
+
+    private:
+        struct Schema {
+            std::string event;
+            std::vector<std::pair<std::string, KvType>> fields;
+        };
+        std::vector<Schema> schemas_;
+};
+
+// Renders a decoded record as one JSON line (same shape as LogFormat::Json).
+void append_json_record(const DecodedRecord& record, std::string& out);
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Sparse sidecar index ("<log>.idx") mapping timestamps to byte offsets in the
+// log file. Every offset is a point where a reader can start decoding: a line
+// start for text/JSON, a stream preamble for binary, a frame header for
+// compressed files (INDEX_FRAMED). An entry covers the segment from its offset
+// to the next entry's and is appended once that segment is complete.
+struct IndexHeader {
+    char magic[4];
+    uint32_t flags;
+};
+
+// Records are not strictly in time order (a flight-recorder dump writes older
+// history after newer entries), so each segment carries its oldest and newest
+// timestamp rather than just the first one.
+struct IndexEntry {
+    uint64_t first_timestamp;   // oldest record in the segment
+    uint64_t last_timestamp;    // newest record in the segment
+    uint64_t offset;
+};
+
+constexpr char INDEX_MAGIC[4] = {'A', 'L', 'I', '2'};
+constexpr uint32_t INDEX_FRAMED = 1;
+
+std::string index_path_for(const std::string& log_path);
+
+// Appends entries; used by the consumer (plain files) or compression thread.
+class LogIndexWriter {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or an existing
+        // index was written for a different layout.
+        LogIndexWriter(const std::string& path, uint32_t flags);
+
+        void add(uint64_t first_timestamp, uint64_t last_timestamp, uint64_t offset);
+        void flush();
+
+    private:
+        std::ofstream file_;
+};
+
+// Read-only mmap view of an index file, plus the running newest / trailing
+// oldest timestamps that make both lookups binary searches.
+class LogIndexReader {
+    public:
+        // Throws std::runtime_error if the file is missing or malformed.
+        explicit LogIndexReader(const std::string& path);
+        ~LogIndexReader();
+
+        LogIndexReader(const LogIndexReader&) = delete;
+        LogIndexReader& operator=(const LogIndexReader&) = delete;
+
+        bool framed() const {return (header_->flags & INDEX_FRAMED) != 0;}
+        size_t size() const {return count_;}
+        const IndexEntry& operator[](size_t i) const {return entries_[i];}
+
+        // Offset to start scanning for records at or after `timestamp`: every
+        // record before it is older.
+        uint64_t seek_offset(uint64_t timestamp) const;
+        // Offset past which every indexed record is newer than `timestamp`,
+        // or UINT64_MAX when the range runs to the end of the file.
+        uint64_t stop_offset(uint64_t timestamp) const;
+
+    private:
+        void* map_;
+        size_t map_size_;
+        const IndexHeader* header_;
+        const IndexEntry* entries_;
+        size_t count_;
+        std::vector<uint64_t> newest_through_;  // max last_timestamp of entries [0, i]
+        std::vector<uint64_t> oldest_from_;     // min first_timestamp of entries [i, count)
+};
@@ -4,12 +4,116 @@
 #include <thread>
 #include <fstream>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "ring_buffer.hpp"
+#include "compressed_writer.hpp"
+#include "flight_recorder.hpp"
+#include "log_format.hpp"
+#include "log_index.hpp"
+#include "per_thread.hpp"
+#include "rate_limit.hpp"
+#include "shm_ring.hpp"
+#include "slab_pool.hpp"
+
+class LogBackend;
+
+enum class Compression {
+    None,
+    LZ4,    // LZ4 block frames; read back with the logcat tool
+};
+
+// Called on the consumer thread when ring occupancy rises through a watermark.
+// `level` indexes LoggerOptions::watermarks.
+using WatermarkCallback = std::function<void(size_t level, size_t occupancy, size_t capacity)>;
+
+struct LoggerOptions {
+    // Ascending occupancy fractions in (0, 1], e.g. {0.5, 0.8, 0.95}.
+    std::vector<double> watermarks;
+    WatermarkCallback on_watermark;
+
+    // Consumer sleep when the ring is empty and no watermark was hit recently.
+    std::chrono::microseconds idle_sleep{100000};
+    // After a watermark crossing the consumer yields instead of sleeping for this long.
+    std::chrono::microseconds hot_period{10000};
+    // Entries written per flush at level 0; doubles with each watermark level reached.
+    size_t batch_size = 64;
+
+    LogFormat format = LogFormat::Text;
+    // String bytes in Text output: Raw writes them verbatim, Text escapes
+    // control bytes so every record stays on one line. Json always escapes.
+    EscapeMode text_escape = EscapeMode::Raw;
+    // Decimals for log_kv doubles in Text/Json output (0-9, e.g. 2 for
+    // prices); -1 writes the shortest form that parses back exactly.
+    int double_precision = -1;
+    Compression compression = Compression::None;
+    // Formatted bytes collected before a frame is handed to the compression thread.
+    size_t compression_block_size = 64 * 1024;
+
+    // Sparse "<file>.idx" sidecar for logquery. Plain files get an entry every
+    // index_interval_records entries or index_interval_bytes bytes, whichever
+    // comes first; compressed files get one per frame.
+    bool write_index = false;
+    size_t index_interval_records = 1024;
+    size_t index_interval_bytes = 64 * 1024;
+
+    // Opt-in producer staging: each thread collects up to this many entries
+    // locally and publishes them to the ring with one index update, when the
+    // buffer fills, on commit(), or once the oldest staged entry is older than
+    // staging_flush_interval. The owner checks the age on its next log call;
+    // for a thread that has gone idle, the in-process consumer writes the
+    // stale entries itself when it next finds the ring empty (within about
+    // idle_sleep; manual_drain: on the next drain()). With shared_memory there
+    // is no such consumer and idle threads need commit(). 0 disables staging.
+    size_t staging_capacity = 0;
+    std::chrono::microseconds staging_flush_interval{100};
+
+    // Put the ring in a POSIX shared-memory segment and leave draining,
+    // formatting and I/O to the logd daemon. `filename` only names the
+    // segment ("async_logger.<filename>.<pid>.<seq>", '/' becomes '_'); no
+    // thread or file is created in this process. logd writes
+    // <dir>/<filename>.<pid>.<seq>.log in the format and escaping given by
+    // its own --format/--escape flags, so the writer options above (format
+    // through index, batch_size, idle_sleep, hot_period, watermarks) must
+    // keep their defaults; the constructor throws std::invalid_argument
+    // otherwise.
+    bool shared_memory = false;
+
+    // Flight recorder: entries at or below flight_recorder_level are not
+    // written but kept in a per-thread history of flight_recorder_capacity
+    // slots, overwriting the oldest. An entry at or above
+    // flight_recorder_trigger, or dump(), makes the consumer write out every
+    // thread's history merged by timestamp. Not available with shared_memory.
+    bool flight_recorder = false;
+    LogLevel flight_recorder_level = LogLevel::Debug;
+    LogLevel flight_recorder_trigger = LogLevel::Error;
+    size_t flight_recorder_capacity = 1024;
+
+    // Start no consumer thread: the application calls drain() itself, e.g.
+    // from an event loop when notify_fd() becomes readable and on a timer for
+    // the entries below the threshold. The destructor drains what is left.
+    bool manual_drain = false;
+    // Ring occupancy at which producers signal notify_fd().
+    size_t notify_threshold = 256;
+
+    // Drain on this shared backend's thread instead of starting one. The
+    // backend must outlive the logger.
+    LogBackend* backend = nullptr;
+
+    // How often the consumer writes the counts held back by LOG_LIMITED sites
+    // that have not got through since (checked whenever it runs). Whatever is
+    // left is logged by the destructor.
+    std::chrono::milliseconds suppressed_report_interval{1000};
+};
 
 class Logger {
     public:
         Logger(const std::string& filename, size_t buffer_size = 1024);
+        Logger(const std::string& filename, const LoggerOptions& options);
         ~Logger();
 
         Logger(const Logger&) = delete;
@@ -17,24 +121,157 @@ class Logger {
         Logger(Logger&&) = delete;
         Logger& operator=(Logger&&) = delete;
 
+        // The level-less overloads log at INFO.
         void log(const std::string& message);
+        void log(LogLevel level, const std::string& message);
+        // Structured event, e.g. log_kv("fill", {{"px", 101.25}, {"qty", 300}}).
+        // Fields are stored typed in the ring and rendered by the consumer.
+        void log_kv(const char* event, std::initializer_list<KvField> fields);
+        void log_kv(LogLevel level, const char* event, std::initializer_list<KvField> fields);
+        // Logs through a call-site limiter; use LOG_LIMITED / LOG_KV_LIMITED.
+        void log_limited(CallSiteLimiter& limiter, LogLevel level, const std::string& message);
+        void log_kv_limited(CallSiteLimiter& limiter, LogLevel level, const char* event,
+                            std::initializer_list<KvField> fields);
+        // Publishes the calling thread's staged entries (no-op without staging).
+        // Threads that go quiet should call this; the destructor commits all threads.
+        void commit();
+        // Asks the consumer to write out the flight recorder history (no-op
+        // without flight_recorder).
+        void dump();
+
+        // Writes up to max_records entries, stopping early once `deadline`
+        // passes, and flushes the output once the ring is empty. Returns the
+        // number written. manual_drain only; call from one thread at a time.
+        size_t drain(size_t max_records = SIZE_MAX,
+                     std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+        // Non-blocking eventfd that becomes readable when occupancy reaches
+        // notify_threshold or a flight-recorder dump is requested; drain()
+        // resets it. -1 without manual_drain.
+        int notify_fd() const {return notify_fd_;}
 
         uint64_t get_dropped_count() const {return dropped_count_.load();}
+        // Entries published but not yet taken by the consumer (approximate from
+        // other threads; staged entries are not counted).
+        size_t get_queue_depth() const {return ring_->size();}
+        // Number of times occupancy rose through watermark `level`; 0 for a
+        // level that was not configured.
+        uint64_t get_watermark_hits(size_t level) const {
+            return level < watermark_thresholds_.size() ? watermark_hits_[level].load() : 0;
+        }
 
     private:
-        struct LogEntry{
-            char message[512];
-            size_t length;
-            uint64_t timestamp;
+        friend class LogBackend;
+
+        // `busy` is held by the owner from begin_entry() to publish() and by
+        // the consumer while it takes over a stale buffer.
+        struct StagingBuffer {
+            explicit StagingBuffer(size_t capacity) : entries(capacity), count(0), busy(false) {}
+            std::vector<LogEntry> entries;
+            size_t count;
+            std::atomic<bool> busy;
+
+            void lock() {
+                while (busy.exchange(true, std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+            }
+            bool try_lock() {return !busy.exchange(true, std::memory_order_acquire);}
+            void unlock() {busy.store(false, std::memory_order_release);}
         };
 
-        RingBuffer<LogEntry, 1024> ring_buffer_;
+        std::unique_ptr<LogRing> owned_ring_;
+        std::unique_ptr<ShmRing> shm_;
+        LogRing* ring_;             // owned_ring_ or the shared-memory ring
+        std::unique_ptr<SlabPool> owned_pool_;
+        SlabPool* pool_;            // payloads too big for a ring slot; owned_pool_, the backend's or shm
         std::thread background_thread_;
         std::atomic<bool> shutdown_flag_;
         std::atomic<uint64_t> dropped_count_;
         std::ofstream log_file_;
 
+        LoggerOptions options_;
+        std::vector<size_t> watermark_thresholds_;
+        std::unique_ptr<std::atomic<uint64_t>[]> watermark_hits_;
+        size_t watermark_level_;  // consumer thread only
+
+        // Formatted text not yet written and the oldest/newest timestamp in it
+        // (UINT64_MAX/0 when empty); consumer thread only.
+        std::string pending_;
+        uint64_t pending_first_ts_;
+        uint64_t pending_last_ts_;
+        std::unique_ptr<CompressedWriter> compressor_;
+        LogFormatter formatter_;
+        bool stream_start_pending_;  // next entry starts a self-contained stream segment
+
+        std::unique_ptr<LogIndexWriter> index_;
+        uint64_t file_offset_;          // bytes in the file, plain output only
+        uint64_t last_index_offset_;    // start of the open index segment
+        size_t records_since_index_;
+        uint64_t index_first_ts_;       // oldest/newest record in the open segment
+        uint64_t index_last_ts_;
+
+        PerThread<StagingBuffer> staging_;
+        uint64_t staging_flush_interval_ns_;
+
+        PerThread<FlightRecorder> history_;
+        std::atomic<bool> dump_requested_;
+        std::atomic<uint64_t> dump_timestamp_;   // trigger of the requested dump; 0 after dump()
+
+        uint64_t id_;   // never reused, so limiters can cache their SuppressedCount
+        std::mutex suppressed_mutex_;
+        std::vector<std::shared_ptr<SuppressedCount>> suppressed_sites_;
+        std::atomic<bool> has_suppressed_sites_;
+        std::chrono::steady_clock::time_point next_suppressed_report_;  // consumer only
+
+        int notify_fd_;
+        std::atomic<bool> notify_armed_;   // producers signal at most once per drain()
+        std::chrono::steady_clock::time_point hot_until_;  // consumer only
+
+        bool to_history(LogLevel level) const {
+            return options_.flight_recorder && level <= options_.flight_recorder_level;
+        }
+        char* reserve_payload(LogEntry& entry, size_t size);
+        void stamp(LogEntry& entry, LogLevel level, EntryKind kind, size_t length);
+        void discard(const LogEntry& entry);
+        void after_publish(const LogEntry& entry);
+        SuppressedCount& suppressed_count(CallSiteLimiter& limiter, LogLevel level);
+        void report_suppressed(SuppressedCount& site, LogLevel level);
+        void write_suppressed();
+        LogEntry& begin_entry(LogEntry& local);
+        void abandon_entry();
+        void publish(const LogEntry& entry);
+        void commit_staged(StagingBuffer& stage);
+        void write_stale_staging();
+        void notify_consumer();
+        void signal_notify_fd();
         void background_worker();
+        size_t drain_some(size_t max_records, std::chrono::steady_clock::time_point deadline);
+        size_t drain_step(size_t max_records);
+        void drain_remaining();
+        size_t write_batch(size_t max_entries);
+        void write_entry(const LogEntry& entry, const char* payload);
+        void write_flight_recorder();
+        void close_index_segment();
+        void flush_pending();
+        size_t update_watermark_level();
         uint64_t get_timestamp_ns();
-        std::string format_log_entry(const LogEntry& entry);
-};
\ No newline at end of file
+};
+
+// Rate-limited logging from one call site, e.g.
+//   LOG_LIMITED(logger, LogLevel::Warn, 100, 10, "feed gap on " + symbol);
+// lets each thread through this line in bursts of 10 and 100/s sustained, and
+// collapses repeats of the same message within a second. What was held back is
+// logged as a "suppressed" event the next time the site gets through, by the
+// consumer every suppressed_report_interval, or at shutdown.
+#define LOG_LIMITED(logger, level, per_second, burst, message) \
+    do { \
+        static thread_local CallSiteLimiter log_limiter_(__FILE__, __LINE__, per_second, burst); \
+        (logger).log_limited(log_limiter_, level, message); \
+    } while (0)
+
+// Same for log_kv; only the token bucket applies.
+#define LOG_KV_LIMITED(logger, level, per_second, burst, event, ...) \
+    do { \
+        static thread_local CallSiteLimiter log_limiter_(__FILE__, __LINE__, per_second, burst); \
+        (logger).log_kv_limited(log_limiter_, level, event, __VA_ARGS__); \
+    } while (0)
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free number-to-text kernels for the consumer thread. Each writes
+// at `out` and returns one past the last character, like std::to_chars, and
+// produces exactly the text std::to_chars would.
+
+// Longest output of format_uint / format_int / format_double.
+constexpr size_t NUMBER_CHARS_MAX = 24;
+// Longest output of format_fixed (DBL_MAX with 9 decimals).
+constexpr size_t FIXED_CHARS_MAX = 330;
+
+// Decimal digits in v (1 for 0), without a loop or division.
+int decimal_digits(uint64_t v);
+
+// Two digits per step from a 200-byte pair table.
+char* format_uint(char* out, uint64_t v);
+char* format_int(char* out, int64_t v);
+
+// Shortest text that parses back to exactly `v` (Schubfach), laid out like
+// std::to_chars(first, last, v): fixed or scientific, whichever is shorter.
+// `v` must be finite.
+char* format_double(char* out, double v);
+
+// `v` rounded to `precision` decimals (0-9), like std::to_chars(...,
+// std::chars_format::fixed, precision): round-half-even on the exact binary
+// value, so 0.125 -> "0.12". Values with |v| * 10^precision >= 2^52 take
+// the std::to_chars path. `v` must be finite.
+char* format_fixed(char* out, double v, int precision);
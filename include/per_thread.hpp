@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// One T per calling thread, owned by this object (not by the thread), so a
+// thread that exits or switches to another owner never leaves dangling state.
+// local() checks a small thread_local cache keyed by instance id on the fast
+// path, so a thread alternating between a few PerThread<T> objects stays off
+// the mutex; the first call from a thread, or a call after the cache entry
+// was evicted, takes the mutex to find or create the slot.
+template <typename T>
+class PerThread {
+    public:
+        PerThread() : id_(next_id()) {}
+
+        PerThread(const PerThread&) = delete;
+        PerThread& operator=(const PerThread&) = delete;
+
+        template <typename... Args>
+        T& local(Args&&... args) {
+            thread_local Cache cache;
+            for (auto& way : cache.ways) {
+                if (way.owner == id_) {
+                    return *way.slot;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            lookups_++;
+            std::thread::id self = std::this_thread::get_id();
+            T* slot = nullptr;
+            for (auto& entry : slots_) {
+                if (entry.first == self) {
+                    slot = entry.second.get();
+                    break;
+                }
+            }
+            if (!slot) {
+                slots_.emplace_back(self, std::unique_ptr<T>(new T(std::forward<Args>(args)...)));
+                slot = slots_.back().second.get();
+            }
+            // Ids are never reused, so entries left by destroyed instances
+            // can only be evicted, never matched.
+            auto& way = cache.ways[cache.next++ % CACHE_WAYS];
+            way.owner = id_;
+            way.slot = slot;
+            return *slot;
+        }
+
+        // Visits every thread's slot. The caller must ensure the owning threads
+        // are not touching their slots concurrently (or that T is safe to share).
+        template <typename F>
+        void for_each(F&& f) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& entry : slots_) {
+                f(*entry.second);
+            }
+        }
+
+        // Calls to local() that missed the thread's cache.
+        uint64_t lookups() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return lookups_;
+        }
+
+    private:
+        static constexpr size_t CACHE_WAYS = 4;
+
+        struct Cache {
+            struct Way {
+                uint64_t owner = 0;
+                T* slot = nullptr;
+            };
+            Way ways[CACHE_WAYS];
+            size_t next = 0;
+        };
+
+        static uint64_t next_id() {
+            static std::atomic<uint64_t> counter{0};
+            return ++counter;   // never 0, never reused
+        }
+
+        uint64_t id_;
+        std::mutex mutex_;
+        uint64_t lookups_ = 0;
+        std::vector<std::pair<std::thread::id, std::unique_ptr<T>>> slots_;
+};
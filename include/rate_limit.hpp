@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "log_format.hpp"
+
+// Entries one limiter suppressed for one Logger. The Logger and the limiter
+// share it, so the Logger's consumer can report a flood that stops without the
+// site getting through again. Only the limiter's thread adds; whichever side
+// reports first claims the count, so nothing is reported twice. Once the
+// limiter lets go (thread exit, or use with another Logger) the count is
+// final, and the Logger drops it after reporting it.
+struct SuppressedCount {
+    SuppressedCount(const char* file, int line, LogLevel level)
+        : file(file), line(line), level(level), total(0), reported(0), released(false) {}
+
+    void add() {
+        total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Suppressed since the last claim.
+    uint64_t claim() {
+        uint64_t t = total.load(std::memory_order_relaxed);
+        uint64_t r = reported.load(std::memory_order_relaxed);
+        while (r < t && !reported.compare_exchange_weak(r, t, std::memory_order_relaxed)) {}
+        return r < t ? t - r : 0;
+    }
+
+    const char* file;
+    int line;
+    LogLevel level;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> reported;
+    std::atomic<bool> released;     // set by the limiter after its last add()
+};
+
+// Producer-side limiter for one call site on one thread (see LOG_LIMITED).
+// Plain members only: every thread gets its own copy, so there is nothing
+// shared to contend on.
+//
+// Two filters, checked in order:
+//  - a message identical to the last one admitted here within repeat_window
+//    is collapsed;
+//  - otherwise a token bucket allows `burst` messages at once and
+//    `per_second` sustained (GCRA: one "theoretical arrival time" instead of
+//    a token count).
+// What is suppressed is counted in the Logger's SuppressedCount for this
+// site; the limiter caches the one for the Logger it was last used with.
+class CallSiteLimiter {
+    public:
+        CallSiteLimiter(const char* file, int line, double per_second, uint32_t burst,
+                        uint64_t repeat_window_ns = 1000000000ull)
+            : file_(basename(file)), line_(line),
+              interval_ns_(per_second > 0 ? static_cast<uint64_t>(1e9 / per_second) : 0),
+              tolerance_ns_(interval_ns_ * (burst > 0 ? burst - 1 : 0)),
+              repeat_window_ns_(repeat_window_ns), tat_ns_(0), last_admit_ns_(0),
+              owner_(0) {}
+
+        ~CallSiteLimiter() {release();}
+
+        // `message` may be null to skip duplicate detection.
+        bool admit(uint64_t now_ns, const char* message, size_t length) {
+            if (message && last_admit_ns_ != 0 && now_ns - last_admit_ns_ < repeat_window_ns_ &&
+                length == last_.size() && std::memcmp(message, last_.data(), length) == 0) {
+                return false;
+            }
+            if (tat_ns_ > now_ns + tolerance_ns_) {
+                return false;
+            }
+            tat_ns_ = (tat_ns_ > now_ns ? tat_ns_ : now_ns) + interval_ns_;
+            last_admit_ns_ = now_ns;
+            if (message) {
+                last_.assign(message, length);
+            }
+            return true;
+        }
+
+        const char* file() const {return file_;}
+        int line() const {return line_;}
+
+        // The count bound for the Logger with instance id `owner`, if cached.
+        SuppressedCount* counter(uint64_t owner) const {return owner == owner_ ? counter_.get() : nullptr;}
+        void bind(uint64_t owner, std::shared_ptr<SuppressedCount> counter) {
+            release();
+            owner_ = owner;
+            counter_ = std::move(counter);
+        }
+
+    private:
+        void release() {
+            if (counter_) {
+                counter_->released.store(true, std::memory_order_release);
+                counter_.reset();
+            }
+        }
+
+        static const char* basename(const char* path) {
+            const char* slash = std::strrchr(path, '/');
+            return slash ? slash + 1 : path;
+        }
+
+        const char* file_;
+        int line_;
+        uint64_t interval_ns_;
+        uint64_t tolerance_ns_;
+        uint64_t repeat_window_ns_;
+        uint64_t tat_ns_;
+        uint64_t last_admit_ns_;
+        std::string last_;
+        uint64_t owner_;                // Logger ids are never reused
+        std::shared_ptr<SuppressedCount> counter_;
+};
@@ -1,53 +1,144 @@
 #pragma once
 #include <atomic>
 #include <cstddef>
+#include <limits>
+#include <type_traits>
 
+// Memory-ordering policies for RingBuffer. `load` is used where one side
+// reads the other side's index, `store` where it publishes its own.
+struct AcquireRelease {
+    static constexpr std::memory_order load = std::memory_order_acquire;
+    static constexpr std::memory_order store = std::memory_order_release;
+    static constexpr const char* name = "acq_rel";
+};
 
-template <typename T, std::size_t Capacity>
+// Every index access is seq_cst; the baseline the acquire/release version replaced.
+struct SequentiallyConsistent {
+    static constexpr std::memory_order load = std::memory_order_seq_cst;
+    static constexpr std::memory_order store = std::memory_order_seq_cst;
+    static constexpr const char* name = "seq_cst";
+};
+
+// Policy parameters (the defaults are the layout LogRing and the shared
+// memory segment rely on):
+//   Index        - unsigned index type; uint32_t halves the index footprint.
+//                  Indices wrap, so any width works as long as it can count
+//                  past Capacity.
+//   Padding      - alignment of the producer line, consumer line and
+//                  storage; 128 keeps Intel's adjacent-line prefetcher from
+//                  pairing the two indices.
+//   Ordering     - AcquireRelease or SequentiallyConsistent.
+//   CacheIndices - each side keeps a private copy of the other's index and
+//                  only reloads it when the ring looks full (producer) or
+//                  empty (consumer), so most operations touch no shared line.
+template <typename T, std::size_t Capacity,
+          typename Index = std::size_t,
+          std::size_t Padding = 64,
+          typename Ordering = AcquireRelease,
+          bool CacheIndices = false>
 class RingBuffer{
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_unsigned<Index>::value, "Index must be an unsigned integer type");
+    static_assert(Capacity - 1 <= std::numeric_limits<Index>::max(), "Index too narrow for Capacity");
+    static_assert((Padding & (Padding - 1)) == 0 && Padding >= alignof(std::atomic<Index>),
+                  "Padding must be a power of two");
 
     public:
-        RingBuffer(): head_(0), tail_(0) {}
-        
+        RingBuffer(): head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
         bool try_push(const T& item) {
-            size_t cur_head = head_.load(std::memory_order_relaxed);
-            size_t cur_tail = tail_.load(std::memory_order_acquire);
+            Index cur_head = head_.load(std::memory_order_relaxed);
 
-            if (((cur_head - cur_tail) & mask) == mask) {
-                return false; 
+            if (free_slots(cur_head, 1) == 0) {
+                return false;
             }
 
             buffer_[cur_head & mask] = item;
-            head_.store(cur_head + 1, std::memory_order_release);
+            head_.store(static_cast<Index>(cur_head + 1), Ordering::store);
 
             return true;
 
         }
+        // Publishes up to `count` items with a single index update; returns how
+        // many fit. Amortizes the cross-core traffic on head_/tail_ over a batch.
+        size_t try_push_bulk(const T* items, size_t count) {
+            Index cur_head = head_.load(std::memory_order_relaxed);
+
+            size_t free = free_slots(cur_head, count);
+            size_t n = count < free ? count : free;
+
+            for (size_t i = 0; i < n; i++) {
+                buffer_[(cur_head + i) & mask] = items[i];
+            }
+            if (n > 0) {
+                head_.store(static_cast<Index>(cur_head + n), Ordering::store);
+            }
+
+            return n;
+        }
         bool try_pop(T& item){
-            size_t cur_tail = tail_.load(std::memory_order_relaxed);
-            size_t cur_head = head_.load(std::memory_order_acquire);
+            Index cur_tail = tail_.load(std::memory_order_relaxed);
 
-            if (cur_tail == cur_head) {
+            if (!has_items(cur_tail)) {
                 return false; // Buffer is empty
             }
 
             item = buffer_[cur_tail & mask];
-            tail_.store(cur_tail + 1, std::memory_order_release);
+            tail_.store(static_cast<Index>(cur_tail + 1), Ordering::store);
 
             return true;
-           
+
         }
         bool is_empty() const {
             return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
         }
         bool is_full() const {
-            return ((head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed)) & mask) == mask;
+            return size() == mask;
         }
-    
+        // Approximate occupancy; exact when called from the producer or consumer thread.
+        size_t size() const {
+            return static_cast<Index>(head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed)) & mask;
+        }
+        // Usable slots (one slot is reserved to tell full from empty).
+        static constexpr size_t capacity() { return mask; }
+
     private:
         static constexpr size_t mask = Capacity - 1;
-        alignas(64) std::atomic<size_t> head_;
-        alignas(64) std::atomic<size_t> tail_;
-        T buffer_[Capacity];
-};
\ No newline at end of file
+
+        // Producer side: free slots as of the last tail_ load. With caching,
+        // tail_ is only reloaded when the cached value cannot satisfy `wanted`.
+        size_t free_slots(Index cur_head, size_t wanted) {
+            if constexpr (CacheIndices) {
+                size_t free = mask - (static_cast<Index>(cur_head - cached_tail_) & mask);
+                if (free >= wanted) {
+                    return free;
+                }
+                cached_tail_ = tail_.load(Ordering::load);
+                return mask - (static_cast<Index>(cur_head - cached_tail_) & mask);
+            } else {
+                Index cur_tail = tail_.load(Ordering::load);
+                return mask - (static_cast<Index>(cur_head - cur_tail) & mask);
+            }
+        }
+
+        // Consumer side: whether slot `cur_tail` has been published.
+        bool has_items(Index cur_tail) {
+            if constexpr (CacheIndices) {
+                if (cur_tail != cached_head_) {
+                    return true;
+                }
+                cached_head_ = head_.load(Ordering::load);
+                return cur_tail != cached_head_;
+            } else {
+                return cur_tail != head_.load(Ordering::load);
+            }
+        }
+
+        // Producer line: its own index plus its copy of the consumer's.
+        alignas(Padding) std::atomic<Index> head_;
+        Index cached_tail_;
+        // Consumer line.
+        alignas(Padding) std::atomic<Index> tail_;
+        Index cached_head_;
+        alignas(Padding) T buffer_[Capacity];
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "ring_buffer.hpp"
+#include "log_format.hpp"
+#include "slab_pool.hpp"
+
+// The ring every Logger publishes into, in process or in shared memory.
+using LogRing = RingBuffer<LogEntry, 1024>;
+
+static_assert(std::is_trivially_copyable<LogEntry>::value, "LogEntry is copied across processes");
+static_assert(std::atomic<size_t>::is_always_lock_free, "Ring indices must be address-free in shared memory");
+
+// Segment layout: ShmRingHeader at offset 0, LogRing at ring_offset, the
+// SlabPool for large payloads at pool_offset.
+// Bump SHM_RING_VERSION whenever LogEntry, LogRing, SlabPool or this header change.
+constexpr uint32_t SHM_RING_VERSION = 3;
+constexpr char SHM_RING_PREFIX[] = "async_logger.";
+
+enum class ShmRingState : uint32_t {
+    Creating = 0,   // producer still initializing; consumers must not attach yet
+    Live = 1,
+    Closed = 2,     // producer shut down cleanly; drain and unlink
+};
+
+struct ShmRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t entry_size;
+    uint64_t capacity;
+    uint64_t ring_offset;
+    uint64_t ring_size;
+    uint64_t pool_offset;
+    uint64_t pool_size;
+    int64_t producer_pid;
+    std::atomic<uint32_t> state;
+    std::atomic<uint64_t> dropped;   // published by the producer on close
+    char name[128];                  // logical name the producer was created with
+};
+
+// A LogRing living in a named POSIX shared-memory segment (shm_open + mmap).
+// The producer creates it; an out-of-process consumer (logd) attaches,
+// drains, and unlinks it once the producer has closed or died. Because the
+// entries live in the segment, they survive a producer crash.
+class ShmRing {
+    public:
+        // Creates "/async_logger.<name>.<pid>.<seq>", with seq counting rings
+        // created by this process, so a closed ring that logd has not drained
+        // yet is never reused. Throws std::runtime_error on failure.
+        static std::unique_ptr<ShmRing> create(const std::string& name);
+        // Attaches as the ring's only consumer (an flock on the segment, held
+        // until this object is destroyed). Throws std::runtime_error if the
+        // segment is missing, still being created, already has a consumer, or
+        // was written by an incompatible build.
+        static std::unique_ptr<ShmRing> attach(const std::string& segment);
+        // Segment names currently present (Linux: scans /dev/shm).
+        static std::vector<std::string> list();
+
+        ~ShmRing();
+        ShmRing(const ShmRing&) = delete;
+        ShmRing& operator=(const ShmRing&) = delete;
+
+        LogRing& ring() {return *ring_;}
+        SlabPool& pool() {return *pool_;}
+        ShmRingHeader& header() {return *header_;}
+        const std::string& segment() const {return segment_;}
+
+        void mark_closed(uint64_t dropped);
+        bool producer_alive() const;
+        // Removes the name. A consumer only removes it while it still refers
+        // to the segment it attached to.
+        void unlink();
+
+    private:
+        ShmRing(std::string segment, int fd, void* base, size_t size);
+
+        std::string segment_;
+        int fd_;        // consumer only: holds the flock; -1 for the producer
+        void* base_;
+        size_t size_;
+        ShmRingHeader* header_;
+        LogRing* ring_;
+        SlabPool* pool_;
+};
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "log_format.hpp"
+
+// Size classes for payloads too big for a ring slot. Total storage is
+// 1.25 MiB; the largest class holds the largest payload a record can carry.
+constexpr size_t SLAB_CLASSES = 5;
+constexpr size_t SLAB_CLASS_SIZE[SLAB_CLASSES] = {256, 1024, 4096, 16384, 65536};
+constexpr uint32_t SLAB_CLASS_COUNT[SLAB_CLASSES] = {1024, 256, 64, 16, 4};
+
+constexpr size_t slab_total_count() {
+    size_t n = 0;
+    for (size_t c = 0; c < SLAB_CLASSES; c++) n += SLAB_CLASS_COUNT[c];
+    return n;
+}
+
+constexpr size_t slab_total_bytes() {
+    size_t n = 0;
+    for (size_t c = 0; c < SLAB_CLASSES; c++) n += SLAB_CLASS_SIZE[c] * SLAB_CLASS_COUNT[c];
+    return n;
+}
+
+// Fixed pool of payload slabs shared by every producer and the consumer.
+// Each size class is a Treiber stack of slab indices; the head packs a
+// version tag with the index so a pop racing a pop+push of the same slab
+// (ABA) fails its CAS. Only indices are stored, never pointers, so the pool
+// also works when placed in shared memory and mapped at different addresses.
+//
+// A handle is (class << 24) | slab index within the class.
+class SlabPool {
+    public:
+        SlabPool() {
+            uint32_t first = 0;
+            for (size_t c = 0; c < SLAB_CLASSES; c++) {
+                first_[c] = first;
+                offset_[c] = c == 0 ? 0 : offset_[c - 1] + SLAB_CLASS_SIZE[c - 1] * SLAB_CLASS_COUNT[c - 1];
+                for (uint32_t i = 0; i < SLAB_CLASS_COUNT[c]; i++) {
+                    // Links are index + 1 so that 0 terminates the list.
+                    next_[first + i].store(i + 1 < SLAB_CLASS_COUNT[c] ? i + 2 : 0, std::memory_order_relaxed);
+                }
+                free_[c].head.store(1, std::memory_order_relaxed);
+                first += SLAB_CLASS_COUNT[c];
+            }
+        }
+
+        SlabPool(const SlabPool&) = delete;
+        SlabPool& operator=(const SlabPool&) = delete;
+
+        // A slab of at least `size` bytes from the smallest class that has one
+        // free, or SLAB_NONE if size > max_size() or every fitting class is empty.
+        uint32_t acquire(size_t size) {
+            for (size_t c = 0; c < SLAB_CLASSES; c++) {
+                if (size > SLAB_CLASS_SIZE[c]) {
+                    continue;
+                }
+                FreeList& list = free_[c];
+                uint64_t head = list.head.load(std::memory_order_acquire);
+                while (static_cast<uint32_t>(head) != 0) {
+                    uint32_t index = static_cast<uint32_t>(head) - 1;
+                    uint32_t next = next_[first_[c] + index].load(std::memory_order_relaxed);
+                    uint64_t replacement = (((head >> 32) + 1) << 32) | next;
+                    if (list.head.compare_exchange_weak(head, replacement, std::memory_order_acquire,
+                                                        std::memory_order_acquire)) {
+                        return static_cast<uint32_t>(c << 24) | index;
+                    }
+                }
+            }
+            return SLAB_NONE;
+        }
+
+        void release(uint32_t handle) {
+            size_t c = handle >> 24;
+            uint32_t index = handle & 0xffffff;
+            FreeList& list = free_[c];
+            uint64_t head = list.head.load(std::memory_order_relaxed);
+            uint64_t replacement;
+            do {
+                next_[first_[c] + index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                replacement = (((head >> 32) + 1) << 32) | (index + 1);
+            } while (!list.head.compare_exchange_weak(head, replacement, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+        }
+
+        char* data(uint32_t handle) {
+            size_t c = handle >> 24;
+            return storage_ + offset_[c] + (handle & 0xffffff) * SLAB_CLASS_SIZE[c];
+        }
+
+        // Where a popped entry's payload lives.
+        const char* payload(const LogEntry& entry) {
+            return entry.slab == SLAB_NONE ? entry.inline_data : data(entry.slab);
+        }
+
+        static constexpr size_t max_size() {return SLAB_CLASS_SIZE[SLAB_CLASSES - 1];}
+
+    private:
+        struct FreeList {
+            alignas(64) std::atomic<uint64_t> head;   // (tag << 32) | (index + 1), low half 0 when empty
+        };
+
+        FreeList free_[SLAB_CLASSES];
+        uint32_t first_[SLAB_CLASSES];    // class's first slot in next_
+        size_t offset_[SLAB_CLASSES];     // class's first byte in storage_
+        std::atomic<uint32_t> next_[slab_total_count()];
+        alignas(64) char storage_[slab_total_bytes()];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Slab free lists need a lock-free 64-bit CAS");
@@ -0,0 +1,74 @@
+#include "compressed_writer.hpp"
+#include "compression.hpp"
+
+CompressedWriter::CompressedWriter(std::ofstream& out, size_t max_pending,
+                                   LogIndexWriter* index, uint64_t file_offset)
+    : out_(out), max_pending_(max_pending > 0 ? max_pending : 1), index_(index), file_offset_(file_offset),
+      busy_(false), shutdown_(false),
+      raw_bytes_(0), compressed_bytes_(0){
+    thread_ = std::thread(&CompressedWriter::worker, this);
+}
+
+CompressedWriter::~CompressedWriter(){
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+    }
+    work_ready_.notify_one();
+
+    if (thread_.joinable()){
+        thread_.join();
+    }
+}
+
+void CompressedWriter::submit(std::string&& block, uint64_t first_timestamp, uint64_t last_timestamp){
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this]{ return queue_.size() < max_pending_; });
+    queue_.push_back(Block{std::move(block), first_timestamp, last_timestamp});
+    lock.unlock();
+    work_ready_.notify_one();
+}
+
+void CompressedWriter::flush(){
+    std::unique_lock<std::mutex> lock(mutex_);
+    work_done_.wait(lock, [this]{ return queue_.empty() && !busy_; });
+}
+
+void CompressedWriter::worker(){
+    std::string frame;
+
+    while (true){
+        Block block;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_ready_.wait(lock, [this]{ return shutdown_ || !queue_.empty(); });
+            if (queue_.empty()){
+                return;  // shutdown with nothing left to write
+            }
+            block = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+        }
+        work_done_.notify_all();
+
+        frame.clear();
+        encode_frame(block.data.data(), block.data.size(), block.first_timestamp,
+                     block.last_timestamp, frame);
+        out_.write(frame.data(), frame.size());
+        out_.flush();
+        if (index_){
+            // Only index frames that are already on disk.
+            index_->add(block.first_timestamp, block.last_timestamp, file_offset_);
+            index_->flush();
+        }
+        file_offset_ += frame.size();
+        raw_bytes_ += block.data.size();
+        compressed_bytes_ += frame.size();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+        }
+        work_done_.notify_all();
+    }
+}
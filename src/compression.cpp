@@ -0,0 +1,240 @@
+#include "compression.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;    // format rule: block ends with >= 5 literals
+constexpr size_t MF_LIMIT = 12;        // format rule: last match starts >= 12 bytes from end
+constexpr size_t MAX_DISTANCE = 65535;
+constexpr int HASH_LOG = 12;
+
+inline uint32_t read32(const uint8_t* p){
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash4(uint32_t sequence){
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+inline uint8_t* write_length(uint8_t* op, size_t len){
+    while (len >= 255){
+        *op++ = 255;
+        len -= 255;
+    }
+    *op++ = static_cast<uint8_t>(len);
+    return op;
+}
+
+uint8_t* emit_sequence(uint8_t* op, const uint8_t* literals, size_t literal_len,
+                       size_t offset, size_t match_len){
+    uint8_t* token = op++;
+    size_t ml = match_len - MIN_MATCH;
+
+    *token = static_cast<uint8_t>((literal_len < 15 ? literal_len : 15) << 4);
+    if (literal_len >= 15){
+        op = write_length(op, literal_len - 15);
+    }
+    std::memcpy(op, literals, literal_len);
+    op += literal_len;
+
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+
+    *token |= static_cast<uint8_t>(ml < 15 ? ml : 15);
+    if (ml >= 15){
+        op = write_length(op, ml - 15);
+    }
+    return op;
+}
+
+uint8_t* emit_last_literals(uint8_t* op, const uint8_t* literals, size_t literal_len){
+    *op++ = static_cast<uint8_t>((literal_len < 15 ? literal_len : 15) << 4);
+    if (literal_len >= 15){
+        op = write_length(op, literal_len - 15);
+    }
+    std::memcpy(op, literals, literal_len);
+    return op + literal_len;
+}
+
+bool read_length(const uint8_t*& ip, const uint8_t* end, size_t& len){
+    uint8_t b;
+    do {
+        if (ip >= end){
+            return false;
+        }
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+} // namespace
+
+size_t lz4_compress_bound(size_t src_size){
+    return src_size + src_size / 255 + 16;
+}
+
+size_t lz4_compress_block(const char* src, size_t src_size, char* dst){
+    const uint8_t* const base = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const end = base + src_size;
+    const uint8_t* anchor = base;
+    uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+
+    if (src_size > MF_LIMIT){
+        const uint8_t* const mf_limit = end - MF_LIMIT;
+        const uint8_t* const match_limit = end - LAST_LITERALS;
+        std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+        const uint8_t* ip = base + 1;
+        size_t misses = 0;
+
+        while (ip < mf_limit){
+            uint32_t sequence = read32(ip);
+            uint32_t h = hash4(sequence);
+            const uint8_t* ref = base + table[h];
+            table[h] = static_cast<uint32_t>(ip - base);
+
+            if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_DISTANCE || read32(ref) != sequence){
+                // Skip faster through incompressible data, like the reference encoder.
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]){
+                ip--;
+                ref--;
+            }
+            size_t match_len = MIN_MATCH;
+            while (ip + match_len < match_limit && ip[match_len] == ref[match_len]){
+                match_len++;
+            }
+
+            op = emit_sequence(op, anchor, ip - anchor, ip - ref, match_len);
+            ip += match_len;
+            anchor = ip;
+            if (ip < mf_limit){
+                table[hash4(read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - base);
+            }
+        }
+    }
+
+    op = emit_last_literals(op, anchor, end - anchor);
+    return op - reinterpret_cast<uint8_t*>(dst);
+}
+
+long lz4_decompress_block(const char* src, size_t src_size, char* dst, size_t dst_capacity){
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* const in_end = ip + src_size;
+    uint8_t* const out = reinterpret_cast<uint8_t*>(dst);
+    uint8_t* op = out;
+    uint8_t* const out_end = out + dst_capacity;
+
+    while (ip < in_end){
+        uint8_t token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(ip, in_end, literal_len)){
+            return -1;
+        }
+        if (literal_len > static_cast<size_t>(in_end - ip) ||
+            literal_len > static_cast<size_t>(out_end - op)){
+            return -1;
+        }
+        std::memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+
+        if (ip == in_end){
+            break;  // last sequence carries literals only
+        }
+
+        if (in_end - ip < 2){
+            return -1;
+        }
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - out)){
+            return -1;
+        }
+
+        size_t match_len = token & 15;
+        if (match_len == 15 && !read_length(ip, in_end, match_len)){
+            return -1;
+        }
+        match_len += MIN_MATCH;
+        if (match_len > static_cast<size_t>(out_end - op)){
+            return -1;
+        }
+
+        const uint8_t* match = op - offset;
+        if (offset >= match_len){
+            std::memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            // Overlapping copy replicates the last `offset` bytes.
+            for (size_t i = 0; i < match_len; i++){
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return static_cast<long>(op - out);
+}
+
+void encode_frame(const char* raw, size_t raw_size, uint64_t first_timestamp,
+                  uint64_t last_timestamp, std::string& out){
+    FrameHeader header{};
+    header.magic = FRAME_MAGIC;
+    header.raw_size = static_cast<uint32_t>(raw_size);
+    header.first_timestamp = first_timestamp;
+    header.last_timestamp = last_timestamp;
+
+    size_t header_pos = out.size();
+    out.resize(header_pos + sizeof(header) + lz4_compress_bound(raw_size));
+    char* payload = &out[header_pos + sizeof(header)];
+
+    size_t stored = lz4_compress_block(raw, raw_size, payload);
+    if (stored >= raw_size){
+        header.flags |= FRAME_STORED;
+        std::memcpy(payload, raw, raw_size);
+        stored = raw_size;
+    }
+    header.stored_size = static_cast<uint32_t>(stored);
+
+    std::memcpy(&out[header_pos], &header, sizeof(header));
+    out.resize(header_pos + sizeof(header) + stored);
+}
+
+bool read_frame(std::istream& in, FrameHeader& header, std::string& raw){
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))){
+        if (in.gcount() == 0){
+            return false;
+        }
+        throw std::runtime_error("Truncated frame header");
+    }
+    if (header.magic != FRAME_MAGIC){
+        throw std::runtime_error("Bad frame magic");
+    }
+
+    std::string stored(header.stored_size, '\0');
+    if (!in.read(&stored[0], header.stored_size)){
+        throw std::runtime_error("Truncated frame payload");
+    }
+
+    if (header.flags & FRAME_STORED){
+        raw = std::move(stored);
+        return true;
+    }
+
+    raw.resize(header.raw_size);
+    long n = lz4_decompress_block(stored.data(), stored.size(), &raw[0], raw.size());
+    if (n != static_cast<long>(header.raw_size)){
+        throw std::runtime_error("Corrupt frame payload");
+    }
+    return true;
+}
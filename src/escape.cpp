@@ -0,0 +1,140 @@
+#include "escape.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+inline bool needs_escape(unsigned char c, EscapeMode mode){
+    return c < 0x20 || c == '\\' || (c == '"' && mode == EscapeMode::Json);
+}
+
+// Quotes only matter to JSON; in text mode the quote lanes compare against a
+// second backslash instead, so the same instruction sequence serves both.
+inline char quote_probe(EscapeMode mode){
+    return mode == EscapeMode::Json ? '"' : '\\';
+}
+
+#if defined(__AVX2__)
+
+constexpr size_t SIMD_WIDTH = 32;
+
+inline uint32_t escape_mask(const char* p, char quote){
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    // v <= 0x1f  <=>  max(v, 0x1f) == 0x1f (unsigned)
+    __m256i ctrl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f));
+    __m256i bs = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    __m256i q = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(quote));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(ctrl, _mm256_or_si256(bs, q))));
+}
+
+#elif defined(__SSE2__)
+
+constexpr size_t SIMD_WIDTH = 16;
+
+inline uint32_t escape_mask(const char* p, char quote){
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+    __m128i bs = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    __m128i q = _mm_cmpeq_epi8(v, _mm_set1_epi8(quote));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(ctrl, _mm_or_si128(bs, q))));
+}
+
+#elif defined(__ARM_NEON)
+
+constexpr size_t SIMD_WIDTH = 16;
+
+// NEON has no movemask; narrowing the 0x00/0xff lanes to nibbles gives a
+// 64-bit word with 4 bits per byte.
+inline uint64_t escape_nibbles(const char* p, char quote){
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t hit = vorrq_u8(vcltq_u8(v, vdupq_n_u8(0x20)),
+                              vorrq_u8(vceqq_u8(v, vdupq_n_u8('\\')), vceqq_u8(v, vdupq_n_u8(quote))));
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(hit), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+#endif
+
+const char hex[] = "0123456789abcdef";
+
+void append_escape_sequence(std::string& out, unsigned char c, EscapeMode mode){
+    switch (c){
+        case '"': out += "\\\""; return;
+        case '\\': out += "\\\\"; return;
+        case '\n': out += "\\n"; return;
+        case '\r': out += "\\r"; return;
+        case '\t': out += "\\t"; return;
+        default:
+            out += mode == EscapeMode::Json ? "\\u00" : "\\x";
+            out += hex[c >> 4];
+            out += hex[c & 15];
+    }
+}
+
+} // namespace
+
+size_t escape_scan_scalar(const char* s, size_t n, EscapeMode mode){
+    if (mode == EscapeMode::Raw){
+        return n;
+    }
+    for (size_t i = 0; i < n; i++){
+        if (needs_escape(static_cast<unsigned char>(s[i]), mode)){
+            return i;
+        }
+    }
+    return n;
+}
+
+size_t escape_scan(const char* s, size_t n, EscapeMode mode){
+    if (mode == EscapeMode::Raw){
+        return n;
+    }
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    char quote = quote_probe(mode);
+    for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH){
+        uint32_t mask = escape_mask(s + i, quote);
+        if (mask != 0){
+            return i + __builtin_ctz(mask);
+        }
+    }
+#elif defined(__ARM_NEON)
+    char quote = quote_probe(mode);
+    for (; i + SIMD_WIDTH <= n; i += SIMD_WIDTH){
+        uint64_t nibbles = escape_nibbles(s + i, quote);
+        if (nibbles != 0){
+            return i + (__builtin_ctzll(nibbles) >> 2);
+        }
+    }
+#endif
+    return i + escape_scan_scalar(s + i, n - i, mode);
+}
+
+void append_escaped(std::string& out, const char* s, size_t n, EscapeMode mode){
+    while (n > 0){
+        size_t clean = escape_scan(s, n, mode);
+        out.append(s, clean);
+        if (clean == n){
+            return;
+        }
+        append_escape_sequence(out, static_cast<unsigned char>(s[clean]), mode);
+        s += clean + 1;
+        n -= clean + 1;
+    }
+}
+
+const char* escape_isa(){
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,68 @@
+#include "log_backend.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include "logger.hpp"
+
+LogBackend::LogBackend(std::chrono::milliseconds idle_sleep, size_t batch_size)
+    : idle_sleep_(idle_sleep), batch_size_(std::max<size_t>(batch_size, 1)), pool_(new SlabPool()),
+      epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), next_start_(0), shutdown_flag_(false){
+    if (epoll_fd_ < 0){
+        throw std::runtime_error("Failed to create backend epoll instance");
+    }
+    thread_ = std::thread(&LogBackend::run, this);
+}
+
+LogBackend::~LogBackend(){
+    shutdown_flag_.store(true, std::memory_order_release);
+    if (thread_.joinable()){
+        thread_.join();
+    }
+    ::close(epoll_fd_);
+}
+
+size_t LogBackend::logger_count(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loggers_.size();
+}
+
+void LogBackend::attach(Logger* logger, int notify_fd){
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = logger;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, notify_fd, &event) != 0){
+        throw std::runtime_error("Failed to watch logger notify eventfd");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    loggers_.push_back(logger);
+}
+
+void LogBackend::detach(Logger* logger, int notify_fd){
+    std::lock_guard<std::mutex> lock(mutex_);
+    loggers_.erase(std::remove(loggers_.begin(), loggers_.end(), logger), loggers_.end());
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, notify_fd, nullptr);
+}
+
+void LogBackend::run(){
+    epoll_event events[16];
+    int timeout_ms = static_cast<int>(std::max<int64_t>(idle_sleep_.count(), 1));
+
+    while (!shutdown_flag_.load(std::memory_order_acquire)){
+        size_t written = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t n = loggers_.size();
+            for (size_t i = 0; i < n; i++){
+                written += loggers_[(next_start_ + i) % n]->drain_some(
+                    batch_size_, std::chrono::steady_clock::time_point::max());
+            }
+            next_start_ = n > 0 ? (next_start_ + 1) % n : 0;
+        }
+
+        // Readiness only ends the wait; the next pass drains (and so resets) every eventfd.
+        if (written == 0){
+            ::epoll_wait(epoll_fd_, events, 16, timeout_ms);
+        }
+    }
+}
@@ -0,0 +1,522 @@
+#include "log_format.hpp"
+#include "number_format.hpp"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Producer-side field layout of a kv entry's payload (LogEntry::inline_data,
+// or the slab it points to once the entry outgrows it):
+//   u8 event_len, event, u8 field_count,
+//   { u8 type, u8 key_len, key, value }...
+// where value is 8 raw bytes for numbers, 1 byte for bool, u16 len + bytes for strings.
+struct KvView {
+    const char* event;
+    size_t event_len;
+    size_t field_count;
+    const char* fields;
+    const char* end;
+};
+
+struct FieldView {
+    KvType type;
+    const char* key;
+    size_t key_len;
+    const char* value;
+    size_t value_len;
+};
+
+bool parse_kv(const char* payload, size_t length, KvView& view){
+    const char* p = payload;
+    const char* end = p + length;
+    if (p == end){
+        return false;
+    }
+    view.event_len = static_cast<uint8_t>(*p++);
+    if (static_cast<size_t>(end - p) < view.event_len + 1){
+        return false;
+    }
+    view.event = p;
+    p += view.event_len;
+    view.field_count = static_cast<uint8_t>(*p++);
+    view.fields = p;
+    view.end = end;
+    return true;
+}
+
+size_t value_size(KvType type){
+    switch (type){
+        case KvType::Bool: return 1;
+        case KvType::String: return 0;
+        default: return 8;
+    }
+}
+
+bool next_field(const char*& p, const char* end, FieldView& field){
+    if (end - p < 2){
+        return false;
+    }
+    field.type = static_cast<KvType>(*p++);
+    field.key_len = static_cast<uint8_t>(*p++);
+    if (static_cast<size_t>(end - p) < field.key_len){
+        return false;
+    }
+    field.key = p;
+    p += field.key_len;
+
+    if (field.type == KvType::String){
+        if (end - p < 2){
+            return false;
+        }
+        uint16_t len;
+        std::memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        field.value_len = len;
+    } else {
+        field.value_len = value_size(field.type);
+    }
+    if (static_cast<size_t>(end - p) < field.value_len){
+        return false;
+    }
+    field.value = p;
+    p += field.value_len;
+    return true;
+}
+
+template <typename T>
+T load(const char* p){
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+template <typename T>
+void append_raw(std::string& out, T v){
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+// Runs a number_format kernel straight into the tail of `out`.
+template <typename Kernel>
+void append_number(std::string& out, size_t max_chars, Kernel&& kernel){
+    size_t start = out.size();
+    out.resize(start + max_chars);
+    char* end = kernel(&out[start]);
+    out.resize(end - out.data());
+}
+
+void append_uint(std::string& out, uint64_t v){
+    append_number(out, NUMBER_CHARS_MAX, [v](char* p) {return format_uint(p, v);});
+}
+
+void append_int(std::string& out, int64_t v){
+    append_number(out, NUMBER_CHARS_MAX, [v](char* p) {return format_int(p, v);});
+}
+
+// precision < 0: shortest round-trip; otherwise that many decimals.
+void append_double(std::string& out, double v, bool json, int precision = -1){
+    if (!std::isfinite(v)){
+        out += json ? "null" : (std::isnan(v) ? "nan" : (v > 0 ? "inf" : "-inf"));
+        return;
+    }
+    if (precision < 0){
+        append_number(out, NUMBER_CHARS_MAX, [v](char* p) {return format_double(p, v);});
+    } else {
+        append_number(out, FIXED_CHARS_MAX, [v, precision](char* p) {return format_fixed(p, v, precision);});
+    }
+}
+
+void append_json_string(std::string& out, const char* s, size_t n){
+    out += '"';
+    append_escaped(out, s, n, EscapeMode::Json);
+    out += '"';
+}
+
+// `escape` is the sink's string mode; Json also selects JSON number spellings.
+void append_value(std::string& out, KvType type, const char* value, size_t value_len, EscapeMode escape,
+                  int double_precision){
+    bool json = escape == EscapeMode::Json;
+    switch (type){
+        case KvType::Int: append_int(out, load<int64_t>(value)); break;
+        case KvType::UInt: append_uint(out, load<uint64_t>(value)); break;
+        case KvType::Double: append_double(out, load<double>(value), json, double_precision); break;
+        case KvType::Bool: out += *value ? "true" : "false"; break;
+        case KvType::String:
+            if (json){
+                append_json_string(out, value, value_len);
+            } else {
+                append_escaped(out, value, value_len, escape);
+            }
+            break;
+    }
+}
+
+void append_json_level(std::string& out, LogLevel level){
+    if (level != LogLevel::Info){
+        out += ",\"level\":\"";
+        out += level_name(level);
+        out += '"';
+    }
+}
+
+} // namespace
+
+const char* level_name(LogLevel level){
+    switch (level){
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Fatal: return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+size_t kv_encoded_size(const char* event, std::initializer_list<KvField> fields){
+    size_t size = 2 + std::min<size_t>(std::strlen(event), 255);
+    size_t count = 0;
+    for (const KvField& field : fields){
+        if (count++ == 255){
+            break;
+        }
+        size += 2 + std::min<size_t>(std::strlen(field.key), 255);
+        size += field.type == KvType::String ? 2 + std::min<size_t>(field.str_len, 65535) : value_size(field.type);
+    }
+    return size;
+}
+
+size_t encode_kv(const char* event, std::initializer_list<KvField> fields, char* out, size_t capacity){
+    size_t event_len = std::min<size_t>(std::strlen(event), 255);
+    if (capacity < event_len + 2){
+        return 0;
+    }
+
+    char* p = out;
+    char* end = out + capacity;
+    *p++ = static_cast<char>(event_len);
+    std::memcpy(p, event, event_len);
+    p += event_len;
+    char* count = p++;
+    *count = 0;
+
+    for (const KvField& field : fields){
+        if (static_cast<uint8_t>(*count) == 255){
+            break;
+        }
+        size_t key_len = std::min<size_t>(std::strlen(field.key), 255);
+        size_t fixed = 2 + key_len + (field.type == KvType::String ? 2 : value_size(field.type));
+        if (static_cast<size_t>(end - p) < fixed){
+            break;
+        }
+
+        *p++ = static_cast<char>(field.type);
+        *p++ = static_cast<char>(key_len);
+        std::memcpy(p, field.key, key_len);
+        p += key_len;
+
+        switch (field.type){
+            case KvType::Int: std::memcpy(p, &field.i, 8); p += 8; break;
+            case KvType::UInt: std::memcpy(p, &field.u, 8); p += 8; break;
+            case KvType::Double: std::memcpy(p, &field.d, 8); p += 8; break;
+            case KvType::Bool: *p++ = field.b ? 1 : 0; break;
+            case KvType::String: {
+                // Long strings are truncated to the space left in the entry.
+                uint16_t len = static_cast<uint16_t>(std::min<size_t>({field.str_len, size_t(end - p - 2), 65535}));
+                std::memcpy(p, &len, sizeof(len));
+                p += sizeof(len);
+                std::memcpy(p, field.str, len);
+                p += len;
+                break;
+            }
+        }
+        (*count)++;
+    }
+
+    return p - out;
+}
+
+LogFormatter::LogFormatter(LogFormat format, EscapeMode text_escape, int double_precision)
+    : format_(format), text_escape_(text_escape), double_precision_(double_precision > 9 ? 9 : double_precision) {}
+
+void LogFormatter::begin(std::string& out){
+    if (format_ == LogFormat::Binary){
+        // A new stream restarts schema numbering.
+        schemas_.clear();
+        out.append(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC));
+    }
+}
+
+void LogFormatter::format(const LogEntry& entry, const char* payload, std::string& out){
+    switch (format_){
+        case LogFormat::Text: format_text(entry, payload, out); break;
+        case LogFormat::Json: format_json(entry, payload, out); break;
+        case LogFormat::Binary: format_binary(entry, payload, out); break;
+    }
+}
+
+void LogFormatter::format_text(const LogEntry& entry, const char* payload, std::string& out){
+    out += '[';
+    append_uint(out, entry.timestamp);
+    out += "] ";
+    if (entry.level != LogLevel::Info){
+        out += level_name(entry.level);
+        out += ' ';
+    }
+
+    KvView kv;
+    if (entry.kind != EntryKind::KeyValue || !parse_kv(payload, entry.length, kv)){
+        append_escaped(out, payload, entry.length, text_escape_);
+        out += '\n';
+        return;
+    }
+
+    append_escaped(out, kv.event, kv.event_len, text_escape_);
+    const char* p = kv.fields;
+    FieldView field;
+    for (size_t i = 0; i < kv.field_count && next_field(p, kv.end, field); i++){
+        out += ' ';
+        append_escaped(out, field.key, field.key_len, text_escape_);
+        out += '=';
+        append_value(out, field.type, field.value, field.value_len, text_escape_, double_precision_);
+    }
+    out += '\n';
+}
+
+void LogFormatter::format_json(const LogEntry& entry, const char* payload, std::string& out){
+    out += "{\"ts\":";
+    append_uint(out, entry.timestamp);
+    append_json_level(out, entry.level);
+
+    KvView kv;
+    if (entry.kind != EntryKind::KeyValue || !parse_kv(payload, entry.length, kv)){
+        out += ",\"msg\":";
+        append_json_string(out, payload, entry.length);
+        out += "}\n";
+        return;
+    }
+
+    out += ",\"event\":";
+    append_json_string(out, kv.event, kv.event_len);
+    const char* p = kv.fields;
+    FieldView field;
+    for (size_t i = 0; i < kv.field_count && next_field(p, kv.end, field); i++){
+        out += ',';
+        append_json_string(out, field.key, field.key_len);
+        out += ':';
+        append_value(out, field.type, field.value, field.value_len, EscapeMode::Json, double_precision_);
+    }
+    out += "}\n";
+}
+
+// Binary stream records:
+//   'S' u16 id, u8 event_len, event, u8 n, { u8 type, u8 key_len, key }   schema
+//   'R' u16 id, u64 ts, u8 level, values in schema order                  record
+//   'T' u64 ts, u8 level, u16 len, bytes                                  text
+// A schema is emitted the first time its (event, keys, types) layout appears.
+void LogFormatter::format_binary(const LogEntry& entry, const char* payload, std::string& out){
+    KvView kv;
+    if (entry.kind != EntryKind::KeyValue || !parse_kv(payload, entry.length, kv)){
+        out += 'T';
+        append_raw<uint64_t>(out, entry.timestamp);
+        out += static_cast<char>(entry.level);
+        append_raw<uint16_t>(out, static_cast<uint16_t>(entry.length));
+        out.append(payload, entry.length);
+        return;
+    }
+
+    signature_.assign(kv.event, kv.event_len);
+    const char* p = kv.fields;
+    FieldView field;
+    size_t field_count = 0;
+    for (; field_count < kv.field_count && next_field(p, kv.end, field); field_count++){
+        signature_ += '\0';
+        signature_ += static_cast<char>(field.type);
+        signature_.append(field.key, field.key_len);
+    }
+
+    auto it = schemas_.find(signature_);
+    if (it == schemas_.end()){
+        uint16_t id = static_cast<uint16_t>(schemas_.size());
+        it = schemas_.emplace(signature_, id).first;
+
+        out += 'S';
+        append_raw<uint16_t>(out, id);
+        out += static_cast<char>(kv.event_len);
+        out.append(kv.event, kv.event_len);
+        out += static_cast<char>(field_count);
+        p = kv.fields;
+        for (size_t i = 0; i < field_count && next_field(p, kv.end, field); i++){
+            out += static_cast<char>(field.type);
+            out += static_cast<char>(field.key_len);
+            out.append(field.key, field.key_len);
+        }
+    }
+
+    out += 'R';
+    append_raw<uint16_t>(out, it->second);
+    append_raw<uint64_t>(out, entry.timestamp);
+    out += static_cast<char>(entry.level);
+    p = kv.fields;
+    for (size_t i = 0; i < field_count && next_field(p, kv.end, field); i++){
+        if (field.type == KvType::String){
+            append_raw<uint16_t>(out, static_cast<uint16_t>(field.value_len));
+        }
+        out.append(field.value, field.value_len);
+    }
+}
+
+size_t BinaryLogDecoder::decode(const char* data, size_t size,
+                                const std::function<void(const DecodedRecord&)>& on_record){
+    const char* p = data;
+    const char* end = data + size;
+    DecodedRecord record;
+
+    // Each branch only commits `p` once the whole record is available, so a
+    // caller streaming chunks can resubmit the unconsumed tail.
+    while (p < end){
+        const char* q = p;
+        auto need = [&](size_t n){ return static_cast<size_t>(end - q) >= n; };
+
+        char tag = *q++;
+        if (tag == BINARY_LOG_MAGIC[0]){
+            if (!need(3)){
+                break;
+            }
+            if (std::memcmp(q, BINARY_LOG_MAGIC + 1, 3) != 0){
+                throw std::runtime_error("Bad binary log magic");
+            }
+            schemas_.clear();
+            p = q + 3;
+        } else if (tag == 'S'){
+            if (!need(3)){
+                break;
+            }
+            uint16_t id = load<uint16_t>(q);
+            size_t event_len = static_cast<uint8_t>(q[2]);
+            q += 3;
+            if (!need(event_len + 1)){
+                break;
+            }
+            Schema schema;
+            schema.event.assign(q, event_len);
+            q += event_len;
+            size_t n = static_cast<uint8_t>(*q++);
+            bool complete = true;
+            for (size_t i = 0; i < n; i++){
+                if (!need(2) || !need(2 + static_cast<uint8_t>(q[1]))){
+                    complete = false;
+                    break;
+                }
+                KvType type = static_cast<KvType>(q[0]);
+                size_t key_len = static_cast<uint8_t>(q[1]);
+                schema.fields.emplace_back(std::string(q + 2, key_len), type);
+                q += 2 + key_len;
+            }
+            if (!complete){
+                break;
+            }
+            if (id != schemas_.size()){
+                throw std::runtime_error("Out-of-order schema id");
+            }
+            schemas_.push_back(std::move(schema));
+            p = q;
+        } else if (tag == 'R'){
+            if (!need(11)){
+                break;
+            }
+            uint16_t id = load<uint16_t>(q);
+            if (id >= schemas_.size()){
+                throw std::runtime_error("Record references unknown schema");
+            }
+            const Schema& schema = schemas_[id];
+            record.timestamp = load<uint64_t>(q + 2);
+            record.level = static_cast<LogLevel>(q[10]);
+            record.is_text = false;
+            record.text = schema.event;
+            record.fields.resize(schema.fields.size());
+            q += 11;
+
+            bool complete = true;
+            for (size_t i = 0; i < schema.fields.size(); i++){
+                KvValue& value = record.fields[i].second;
+                record.fields[i].first = schema.fields[i].first;
+                value.type = schema.fields[i].second;
+                size_t len = value_size(value.type);
+                if (value.type == KvType::String){
+                    if (!need(2)){
+                        complete = false;
+                        break;
+                    }
+                    len = load<uint16_t>(q);
+                    q += 2;
+                }
+                if (!need(len)){
+                    complete = false;
+                    break;
+                }
+                switch (value.type){
+                    case KvType::Int: value.i = load<int64_t>(q); break;
+                    case KvType::UInt: value.u = load<uint64_t>(q); break;
+                    case KvType::Double: value.d = load<double>(q); break;
+                    case KvType::Bool: value.b = *q != 0; break;
+                    case KvType::String: value.s.assign(q, len); break;
+                }
+                q += len;
+            }
+            if (!complete){
+                break;
+            }
+            p = q;
+            on_record(record);
+        } else if (tag == 'T'){
+            if (!need(11)){
+                break;
+            }
+            uint16_t len = load<uint16_t>(q + 9);
+            if (!need(11 + len)){
+                break;
+            }
+            record.timestamp = load<uint64_t>(q);
+            record.level = static_cast<LogLevel>(q[8]);
+            record.is_text = true;
+            record.text.assign(q + 11, len);
+            record.fields.clear();
+            p = q + 11 + len;
+            on_record(record);
+        } else {
+            throw std::runtime_error("Unknown binary log record");
+        }
+    }
+
+    return p - data;
+}
+
+void append_json_record(const DecodedRecord& record, std::string& out){
+    out += "{\"ts\":";
+    append_uint(out, record.timestamp);
+    append_json_level(out, record.level);
+    if (record.is_text){
+        out += ",\"msg\":";
+        append_json_string(out, record.text.data(), record.text.size());
+        out += "}\n";
+        return;
+    }
+
+    out += ",\"event\":";
+    append_json_string(out, record.text.data(), record.text.size());
+    for (const auto& field : record.fields){
+        out += ',';
+        append_json_string(out, field.first.data(), field.first.size());
+        out += ':';
+        const KvValue& v = field.second;
+        switch (v.type){
+            case KvType::Int: append_int(out, v.i); break;
+            case KvType::UInt: append_uint(out, v.u); break;
+            case KvType::Double: append_double(out, v.d, true); break;
+            case KvType::Bool: out += v.b ? "true" : "false"; break;
+            case KvType::String: append_json_string(out, v.s.data(), v.s.size()); break;
+        }
+    }
+    out += "}\n";
+}
@@ -0,0 +1,109 @@
+#include "log_index.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::string index_path_for(const std::string& log_path){
+    return log_path + ".idx";
+}
+
+LogIndexWriter::LogIndexWriter(const std::string& path, uint32_t flags){
+    IndexHeader existing{};
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&existing), sizeof(existing));
+        if (in.gcount() > 0){
+            if (in.gcount() != sizeof(existing) ||
+                std::memcmp(existing.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+                existing.flags != flags){
+                throw std::runtime_error("Existing index does not match log layout: " + path);
+            }
+        }
+    }
+
+    file_.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!file_.is_open()){
+        throw std::runtime_error("Failed to open index file");
+    }
+
+    if (std::memcmp(existing.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0){
+        IndexHeader header{};
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        header.flags = flags;
+        file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+}
+
+void LogIndexWriter::add(uint64_t first_timestamp, uint64_t last_timestamp, uint64_t offset){
+    IndexEntry entry{first_timestamp, last_timestamp, offset};
+    file_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+}
+
+void LogIndexWriter::flush(){
+    file_.flush();
+}
+
+LogIndexReader::LogIndexReader(const std::string& path)
+    : map_(nullptr), map_size_(0), header_(nullptr), entries_(nullptr), count_(0){
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0){
+        throw std::runtime_error("Failed to open index file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(IndexHeader)){
+        ::close(fd);
+        throw std::runtime_error("Index file too small: " + path);
+    }
+    map_size_ = st.st_size;
+    map_ = ::mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map_ == MAP_FAILED){
+        map_ = nullptr;
+        throw std::runtime_error("Failed to map index file: " + path);
+    }
+
+    header_ = static_cast<const IndexHeader*>(map_);
+    if (std::memcmp(header_->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0){
+        ::munmap(map_, map_size_);
+        throw std::runtime_error("Bad index magic: " + path);
+    }
+    entries_ = reinterpret_cast<const IndexEntry*>(static_cast<const char*>(map_) + sizeof(IndexHeader));
+    // A torn trailing entry (writer died mid-write) is ignored.
+    count_ = (map_size_ - sizeof(IndexHeader)) / sizeof(IndexEntry);
+
+    newest_through_.resize(count_);
+    oldest_from_.resize(count_);
+    for (size_t i = 0; i < count_; i++){
+        newest_through_[i] = std::max(entries_[i].last_timestamp, i > 0 ? newest_through_[i - 1] : 0);
+    }
+    for (size_t i = count_; i-- > 0;){
+        oldest_from_[i] = std::min(entries_[i].first_timestamp, i + 1 < count_ ? oldest_from_[i + 1] : UINT64_MAX);
+    }
+}
+
+LogIndexReader::~LogIndexReader(){
+    if (map_){
+        ::munmap(map_, map_size_);
+    }
+}
+
+uint64_t LogIndexReader::seek_offset(uint64_t timestamp) const{
+    // First segment whose records, or any earlier segment's, reach `timestamp`.
+    // Past the last indexed segment, the unindexed tail may still hold some.
+    auto it = std::lower_bound(newest_through_.begin(), newest_through_.end(), timestamp);
+    if (it == newest_through_.end()){
+        return count_ == 0 ? 0 : entries_[count_ - 1].offset;
+    }
+    return entries_[it - newest_through_.begin()].offset;
+}
+
+uint64_t LogIndexReader::stop_offset(uint64_t timestamp) const{
+    // First segment from which nothing, here or later, is at or before `timestamp`.
+    auto it = std::upper_bound(oldest_from_.begin(), oldest_from_.end(), timestamp);
+    return it == oldest_from_.end() ? UINT64_MAX : entries_[it - oldest_from_.begin()].offset;
+}
@@ -1,25 +1,167 @@
 #include "logger.hpp"
+#include "log_backend.hpp"
+#include <algorithm>
 #include <iostream>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t next_logger_id(){
+    static std::atomic<uint64_t> counter{0};
+    return ++counter;   // never 0, never reused
+}
+
+} // namespace
 
 Logger::Logger(const std::string& filename, size_t buffer_size)
-    : shutdown_flag_(false), dropped_count_(0){
-    log_file_.open(filename, std::ios::out | std::ios::app);
+    : Logger(filename, LoggerOptions{}){
+    (void)buffer_size;
+}
+
+Logger::Logger(const std::string& filename, const LoggerOptions& options)
+    : ring_(nullptr), pool_(nullptr), shutdown_flag_(false), dropped_count_(0), options_(options), watermark_level_(0),
+      pending_first_ts_(UINT64_MAX), pending_last_ts_(0), formatter_(options.format, options.text_escape, options.double_precision), stream_start_pending_(true),
+      file_offset_(0), last_index_offset_(0), records_since_index_(0), index_first_ts_(UINT64_MAX), index_last_ts_(0),
+      staging_flush_interval_ns_(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          options.staging_flush_interval).count()),
+      dump_requested_(false), dump_timestamp_(0), id_(next_logger_id()), has_suppressed_sites_(false),
+      next_suppressed_report_(std::chrono::steady_clock::now() + options.suppressed_report_interval),
+      notify_fd_(-1), notify_armed_(true){
+    double previous = 0.0;
+    for (double fraction : options_.watermarks){
+        if (fraction <= previous || fraction > 1.0){
+            throw std::invalid_argument("Watermarks must be ascending fractions in (0, 1]");
+        }
+        previous = fraction;
+        size_t threshold = static_cast<size_t>(fraction * LogRing::capacity());
+        watermark_thresholds_.push_back(std::max<size_t>(threshold, 1));
+    }
+    watermark_hits_.reset(new std::atomic<uint64_t>[watermark_thresholds_.size()]());
+    if (options_.batch_size == 0){
+        options_.batch_size = 1;
+    }
+    if (options_.flight_recorder && options_.shared_memory){
+        throw std::invalid_argument("The flight recorder needs the in-process consumer");
+    }
+    if ((options_.manual_drain || options_.backend) && options_.shared_memory){
+        throw std::invalid_argument("Shared-memory rings are drained by logd");
+    }
+    if (options_.shared_memory){
+        // Nothing in the segment tells logd how to write; it uses its own flags.
+        const LoggerOptions defaults;
+        if (options.format != defaults.format || options.text_escape != defaults.text_escape ||
+            options.double_precision != defaults.double_precision ||
+            options.compression != defaults.compression ||
+            options.compression_block_size != defaults.compression_block_size ||
+            options.write_index || options.index_interval_records != defaults.index_interval_records ||
+            options.index_interval_bytes != defaults.index_interval_bytes ||
+            options.batch_size != defaults.batch_size || options.idle_sleep != defaults.idle_sleep ||
+            options.hot_period != defaults.hot_period || !options.watermarks.empty() || options.on_watermark){
+            throw std::invalid_argument("Writer options do not apply to shared-memory rings; logd --format/--escape decide");
+        }
+    }
+    if (options_.manual_drain && options_.backend){
+        throw std::invalid_argument("A logger is drained either manually or by a backend");
+    }
+
+    if (options_.shared_memory){
+        shm_ = ShmRing::create(filename);
+        ring_ = &shm_->ring();
+        pool_ = &shm_->pool();
+        return;
+    }
+    owned_ring_.reset(new LogRing());
+    ring_ = owned_ring_.get();
+    if (options_.backend){
+        pool_ = &options_.backend->pool();
+    } else {
+        owned_pool_.reset(new SlabPool());
+        pool_ = owned_pool_.get();
+    }
+
+    std::ios::openmode mode = std::ios::out | std::ios::app;
+    if (options_.compression != Compression::None || options_.format == LogFormat::Binary){
+        mode |= std::ios::binary;
+    }
+    std::error_code ec;
+    uint64_t existing_size = std::filesystem::file_size(filename, ec);
+    file_offset_ = ec ? 0 : existing_size;
+
+    log_file_.open(filename, mode);
     if (!log_file_.is_open()){
         throw std::runtime_error("Failed to open log file");
 
     }
 
+    if (options_.write_index){
+        uint32_t flags = options_.compression != Compression::None ? INDEX_FRAMED : 0;
+        index_.reset(new LogIndexWriter(index_path_for(filename), flags));
+    }
+    if (options_.compression == Compression::LZ4){
+        compressor_.reset(new CompressedWriter(log_file_, 4, index_.get(), file_offset_));
+    }
+    pending_.reserve(options_.compression_block_size + 1024);
+
+    if (options_.manual_drain || options_.backend){
+        notify_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (notify_fd_ < 0){
+            throw std::runtime_error("Failed to create notify eventfd");
+        }
+        if (options_.backend){
+            // The destructor does not run if we throw, so close the eventfd
+            // here; closing it also drops any epoll watch attach() added.
+            try {
+                options_.backend->attach(this, notify_fd_);
+            } catch (...){
+                ::close(notify_fd_);
+                throw;
+            }
+        }
+        return;
+    }
     background_thread_ = std::thread(&Logger::background_worker, this);
 
 }
 
 Logger::~Logger(){
+    // Producers are quiescent by now, so this thread can log for every limiter
+    // that is still holding counts back, and every thread's staging buffer
+    // can be published.
+    {
+        std::lock_guard<std::mutex> lock(suppressed_mutex_);
+        for (const std::shared_ptr<SuppressedCount>& site : suppressed_sites_){
+            report_suppressed(*site, site->level);
+        }
+    }
+    staging_.for_each([this](StagingBuffer& stage){
+        stage.lock();   // the consumer may still be taking over a stale buffer
+        commit_staged(stage);
+        stage.unlock();
+    });
+    if (shm_){
+        // logd drains what is left and removes the segment.
+        shm_->mark_closed(dropped_count_.load());
+    }
     shutdown_flag_.store(true);
 
     if(background_thread_.joinable()){
         background_thread_.join();
+    } else if (options_.manual_drain || options_.backend){
+        if (options_.backend){
+            options_.backend->detach(this, notify_fd_);
+        }
+        drain_remaining();
+    }
+    if (notify_fd_ >= 0){
+        ::close(notify_fd_);
     }
     
+    compressor_.reset();
+    index_.reset();
+
     if(log_file_.is_open()){
         log_file_.close();
     }
@@ -32,38 +174,517 @@ Logger::~Logger(){
 }
 
 void Logger::log(const std::string& message){
-    LogEntry entry;
+    log(LogLevel::Info, message);
+}
 
-    entry.timestamp = get_timestamp_ns();
+void Logger::log(LogLevel level, const std::string& message){
+    size_t length = std::min(message.size(), LOG_MAX_PAYLOAD);
+    if (to_history(level)){
+        FlightRecorder& history = history_.local(options_.flight_recorder_capacity);
+        FlightRecord& record = history.begin_write();
+        length = std::min(length, sizeof(record.payload));
+        std::memcpy(record.payload, message.data(), length);
+        record.entry.slab = SLAB_NONE;
+        stamp(record.entry, level, EntryKind::Text, length);
+        history.end_write();
+        return;
+    }
+
+    LogEntry local;
+    LogEntry& entry = begin_entry(local);
+    char* payload = reserve_payload(entry, length);
+    if (!payload){
+        abandon_entry();
+        dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::memcpy(payload, message.data(), length);
+    stamp(entry, level, EntryKind::Text, length);
+    publish(entry);
+    after_publish(entry);
 
-    size_t len = std::min(message.size(), sizeof(entry.message) - 1);
-    std::memcpy(entry.message, message.c_str(), len);
-    entry.message[len] = '\0';
-    entry.length = len;
+}
+
+void Logger::log_kv(const char* event, std::initializer_list<KvField> fields){
+    log_kv(LogLevel::Info, event, fields);
+}
+
+void Logger::log_kv(LogLevel level, const char* event, std::initializer_list<KvField> fields){
+    if (to_history(level)){
+        FlightRecorder& history = history_.local(options_.flight_recorder_capacity);
+        FlightRecord& record = history.begin_write();
+        record.entry.slab = SLAB_NONE;
+        stamp(record.entry, level, EntryKind::KeyValue,
+              encode_kv(event, fields, record.payload, sizeof(record.payload)));
+        history.end_write();
+        return;
+    }
 
-    if(!ring_buffer_.try_push(entry)){
+    size_t size = std::min(kv_encoded_size(event, fields), LOG_MAX_PAYLOAD);
+    LogEntry local;
+    LogEntry& entry = begin_entry(local);
+    char* payload = reserve_payload(entry, size);
+    if (!payload){
+        abandon_entry();
         dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
+    stamp(entry, level, EntryKind::KeyValue, encode_kv(event, fields, payload, size));
+    publish(entry);
+    after_publish(entry);
 
 }
 
-void Logger::background_worker(){
-    LogEntry entry;
+void Logger::log_limited(CallSiteLimiter& limiter, LogLevel level, const std::string& message){
+    SuppressedCount& suppressed = suppressed_count(limiter, level);
+    if (!limiter.admit(get_timestamp_ns(), message.data(), message.size())){
+        suppressed.add();
+        return;
+    }
+    report_suppressed(suppressed, level);
+    log(level, message);
+}
+
+void Logger::log_kv_limited(CallSiteLimiter& limiter, LogLevel level, const char* event,
+                            std::initializer_list<KvField> fields){
+    SuppressedCount& suppressed = suppressed_count(limiter, level);
+    if (!limiter.admit(get_timestamp_ns(), nullptr, 0)){
+        suppressed.add();
+        return;
+    }
+    report_suppressed(suppressed, level);
+    log_kv(level, event, fields);
+}
+
+// The limiter's cached count on the fast path; the first call from a limiter,
+// or one after it was used with another logger, registers a new one.
+SuppressedCount& Logger::suppressed_count(CallSiteLimiter& limiter, LogLevel level){
+    if (SuppressedCount* count = limiter.counter(id_)){
+        return *count;
+    }
+
+    auto count = std::make_shared<SuppressedCount>(limiter.file(), limiter.line(), level);
+    {
+        std::lock_guard<std::mutex> lock(suppressed_mutex_);
+        suppressed_sites_.push_back(count);
+        has_suppressed_sites_.store(true, std::memory_order_relaxed);
+    }
+    limiter.bind(id_, count);
+    return *count;
+}
+
+// Logged at the site's own level so it lands wherever the suppressed entries would have.
+void Logger::report_suppressed(SuppressedCount& site, LogLevel level){
+    uint64_t suppressed = site.claim();
+    if (suppressed > 0){
+        log_kv(level, "suppressed", {{"file", site.file}, {"line", site.line}, {"count", suppressed}});
+    }
+}
+
+// Consumer side, for sites that went quiet without getting through again.
+// The consumer cannot push into the ring it drains, so the entries are
+// written directly. Sites whose limiter has let go are dropped once their
+// last count is out.
+void Logger::write_suppressed(){
+    std::lock_guard<std::mutex> lock(suppressed_mutex_);
+    auto kept = suppressed_sites_.begin();
+    for (std::shared_ptr<SuppressedCount>& site : suppressed_sites_){
+        bool released = site->released.load(std::memory_order_acquire);   // before claim()
+        uint64_t suppressed = site->claim();
+        if (suppressed > 0){
+            char payload[256];
+            LogEntry entry;
+            entry.slab = SLAB_NONE;
+            stamp(entry, site->level, EntryKind::KeyValue,
+                  encode_kv("suppressed", {{"file", site->file}, {"line", site->line}, {"count", suppressed}},
+                            payload, sizeof(payload)));
+            write_entry(entry, payload);
+        }
+        if (!released){
+            *kept++ = std::move(site);
+        }
+    }
+    suppressed_sites_.erase(kept, suppressed_sites_.end());
+    has_suppressed_sites_.store(!suppressed_sites_.empty(), std::memory_order_relaxed);
+}
+
+// Small payloads go in the slot itself; anything larger takes a pooled slab,
+// which the consumer returns after writing. Null when the pool has no slab
+// big enough left; the entry is then dropped like one that finds the ring full.
+char* Logger::reserve_payload(LogEntry& entry, size_t size){
+    if (size <= LOG_INLINE_CAPACITY){
+        entry.slab = SLAB_NONE;
+        return entry.inline_data;
+    }
+    entry.slab = pool_->acquire(size);
+    return entry.slab == SLAB_NONE ? nullptr : pool_->data(entry.slab);
+}
+
+void Logger::stamp(LogEntry& entry, LogLevel level, EntryKind kind, size_t length){
+    entry.timestamp = get_timestamp_ns();
+    entry.length = static_cast<uint32_t>(length);
+    entry.kind = kind;
+    entry.level = level;
+}
+
+// An entry that will never reach the consumer gives its slab back.
+void Logger::discard(const LogEntry& entry){
+    if (entry.slab != SLAB_NONE){
+        pool_->release(entry.slab);
+    }
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// A trigger-level entry is published right away and the history dumped
+// alongside it, under the trigger's timestamp.
+void Logger::after_publish(const LogEntry& entry){
+    if (options_.flight_recorder && entry.level >= options_.flight_recorder_trigger){
+        commit();
+        dump_timestamp_.store(entry.timestamp, std::memory_order_relaxed);
+        dump();
+    }
+}
+
+void Logger::commit(){
+    if (options_.staging_capacity > 0){
+        StagingBuffer& stage = staging_.local(options_.staging_capacity);
+        stage.lock();
+        commit_staged(stage);
+        stage.unlock();
+    }
+}
+
+void Logger::dump(){
+    if (options_.flight_recorder){
+        dump_requested_.store(true, std::memory_order_release);
+        signal_notify_fd();
+    }
+}
+
+// With staging the entry is built in place in the thread's staging buffer,
+// otherwise in the caller's stack slot.
+LogEntry& Logger::begin_entry(LogEntry& local){
+    if (options_.staging_capacity == 0){
+        return local;
+    }
+    StagingBuffer& stage = staging_.local(options_.staging_capacity);
+    stage.lock();
+    return stage.entries[stage.count];
+}
+
+// The entry begun last was not published (no slab for its payload).
+void Logger::abandon_entry(){
+    if (options_.staging_capacity > 0){
+        staging_.local(options_.staging_capacity).unlock();
+    }
+}
 
+void Logger::publish(const LogEntry& entry){
+    if (options_.staging_capacity == 0){
+        if(!ring_->try_push(entry)){
+            discard(entry);
+        }
+        notify_consumer();
+        return;
+    }
+
+    StagingBuffer& stage = staging_.local(options_.staging_capacity);
+    stage.count++;
+    if (stage.count == stage.entries.size() ||
+        entry.timestamp - stage.entries[0].timestamp >= staging_flush_interval_ns_){
+        commit_staged(stage);
+    }
+    stage.unlock();
+}
+
+void Logger::commit_staged(StagingBuffer& stage){
+    if (stage.count == 0){
+        return;
+    }
+    size_t pushed = ring_->try_push_bulk(stage.entries.data(), stage.count);
+    for (size_t i = pushed; i < stage.count; i++){
+        discard(stage.entries[i]);
+    }
+    stage.count = 0;
+    notify_consumer();
+}
+
+// Consumer side, when the ring is empty: a thread that staged entries and
+// went quiet would otherwise hold them until its next log call. The consumer
+// cannot push into the ring it drains, so it writes them directly. A buffer
+// whose owner is mid-log, or while the ring still holds older entries (from
+// any thread, possibly this owner), is left for the next pass.
+void Logger::write_stale_staging(){
+    uint64_t now = get_timestamp_ns();
+    staging_.for_each([&](StagingBuffer& stage){
+        if (!stage.try_lock()){
+            return;
+        }
+        if (stage.count > 0 && now - stage.entries[0].timestamp >= staging_flush_interval_ns_ &&
+            ring_->is_empty()){
+            for (size_t i = 0; i < stage.count; i++){
+                const LogEntry& entry = stage.entries[i];
+                write_entry(entry, pool_->payload(entry));
+                if (entry.slab != SLAB_NONE){
+                    pool_->release(entry.slab);
+                }
+            }
+            stage.count = 0;
+        }
+        stage.unlock();
+    });
+}
+
+// Manual-drain loggers only. Producers skip the syscall until drain() re-arms.
+void Logger::notify_consumer(){
+    if (notify_fd_ >= 0 && ring_->size() >= options_.notify_threshold &&
+        notify_armed_.load(std::memory_order_relaxed) &&
+        notify_armed_.exchange(false, std::memory_order_acq_rel)){
+        signal_notify_fd();
+    }
+}
+
+void Logger::signal_notify_fd(){
+    if (notify_fd_ >= 0){
+        uint64_t one = 1;
+        ssize_t r = ::write(notify_fd_, &one, sizeof(one));
+        (void)r;   // EAGAIN only if the counter is saturated, i.e. already readable
+    }
+}
+
+void Logger::background_worker(){
     while(!shutdown_flag_.load(std::memory_order_acquire)){
-        if(ring_buffer_.try_pop(entry)){
-            log_file_ << format_log_entry(entry) << std::endl;
+        if (drain_step(SIZE_MAX) > 0){
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() < hot_until_){
+            std::this_thread::yield();
         } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (options_.staging_capacity > 0){
+                write_stale_staging();
+            }
+            flush_pending();
+            std::this_thread::sleep_for(options_.idle_sleep);
+        }
+    }
+
+    drain_remaining();
+
+}
+
+size_t Logger::drain(size_t max_records, std::chrono::steady_clock::time_point deadline){
+    if (!options_.manual_drain){
+        throw std::logic_error("drain() needs LoggerOptions::manual_drain");
+    }
+    return drain_some(max_records, deadline);
+}
+
+size_t Logger::drain_some(size_t max_records, std::chrono::steady_clock::time_point deadline){
+    // Reset before draining so a crossing during the drain signals again.
+    uint64_t count;
+    ssize_t r = ::read(notify_fd_, &count, sizeof(count));
+    (void)r;
+    notify_armed_.store(true, std::memory_order_release);
+
+    size_t total = 0;
+    while (total < max_records){
+        size_t written = drain_step(max_records - total);
+        if (written == 0){
+            if (options_.staging_capacity > 0){
+                write_stale_staging();
+            }
+            flush_pending();
+            break;
         }
+        total += written;
+        if (std::chrono::steady_clock::now() >= deadline){
+            break;
+        }
+    }
+
+    // Stopped early with the ring still past the threshold: ask to be called again.
+    if (ring_->size() >= options_.notify_threshold){
+        signal_notify_fd();
     }
+    return total;
+}
 
-    while (ring_buffer_.try_pop(entry)){
-        log_file_ << format_log_entry(entry) << std::endl;
+// One consumer step: services a dump request and the suppressed-count timer,
+// then writes one batch sized by the watermark level.
+size_t Logger::drain_step(size_t max_records){
+    if (dump_requested_.load(std::memory_order_relaxed) &&
+        dump_requested_.exchange(false, std::memory_order_acquire)){
+        write_flight_recorder();
+    }
+    if (has_suppressed_sites_.load(std::memory_order_relaxed)){
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_suppressed_report_){
+            write_suppressed();
+            next_suppressed_report_ = now + options_.suppressed_report_interval;
+        }
     }
 
+    size_t level = update_watermark_level();
+    if (level > 0){
+        hot_until_ = std::chrono::steady_clock::now() + options_.hot_period;
+    }
+
+    // Drain harder the fuller the ring is.
+    size_t batch = std::min({options_.batch_size << std::min<size_t>(level, 16), LogRing::capacity(), max_records});
+    return write_batch(batch);
+}
+
+// Shutdown: everything still in the ring goes out and the output is flushed.
+void Logger::drain_remaining(){
+    if (dump_requested_.exchange(false, std::memory_order_acquire)){
+        write_flight_recorder();
+    }
+    while (write_batch(LogRing::capacity()) > 0) {}
+
+    close_index_segment();
+    flush_pending();
+    if (compressor_){
+        compressor_->flush();
+    }
     log_file_.flush();
+}
+
+size_t Logger::write_batch(size_t max_entries){
+    LogEntry entry;
+    size_t written = 0;
+
+    while (written < max_entries && ring_->try_pop(entry)){
+        write_entry(entry, pool_->payload(entry));
+        if (entry.slab != SLAB_NONE){
+            pool_->release(entry.slab);
+        }
+        written++;
+    }
+
+    if (written > 0 && !compressor_){
+        flush_pending();
+    }
+    return written;
+}
 
+void Logger::write_entry(const LogEntry& entry, const char* payload){
+    if (stream_start_pending_){
+        if (index_ && !compressor_){
+            last_index_offset_ = file_offset_ + pending_.size();
+        }
+        formatter_.begin(pending_);
+        stream_start_pending_ = false;
+    }
+    // Ranges, not first/last: a flight-recorder dump writes older history
+    // after newer entries.
+    pending_first_ts_ = std::min(pending_first_ts_, entry.timestamp);
+    pending_last_ts_ = std::max(pending_last_ts_, entry.timestamp);
+    formatter_.format(entry, payload, pending_);
+
+    if (index_ && !compressor_){
+        index_first_ts_ = std::min(index_first_ts_, entry.timestamp);
+        index_last_ts_ = std::max(index_last_ts_, entry.timestamp);
+        if (++records_since_index_ >= options_.index_interval_records ||
+            file_offset_ + pending_.size() - last_index_offset_ >= options_.index_interval_bytes){
+            close_index_segment();
+            stream_start_pending_ = true;
+        }
+    }
+
+    // Compressed output is cut into frames of about one block each; a partial
+    // block is only submitted once the ring goes idle.
+    if (compressor_ && pending_.size() >= options_.compression_block_size){
+        flush_pending();
+    }
+}
+
+// Writes a marker line followed by every thread's history since the last
+// dump, oldest first. The marker carries the trigger's timestamp; history
+// entries keep their original ones, so they sort before the marker in time
+// but follow it in the file.
+void Logger::write_flight_recorder(){
+    std::vector<FlightRecord> records;
+    size_t lost = 0;
+    history_.for_each([&](FlightRecorder& history){ lost += history.snapshot(records); });
+    std::stable_sort(records.begin(), records.end(), [](const FlightRecord& a, const FlightRecord& b){
+        return a.entry.timestamp < b.entry.timestamp;
+    });
+
+    std::string text = "flight recorder: " + std::to_string(records.size()) + " entries follow, " +
+                       std::to_string(lost) + " overwritten";
+    LogEntry marker;
+    marker.slab = SLAB_NONE;
+    stamp(marker, LogLevel::Info, EntryKind::Text, text.size());
+    uint64_t trigger = dump_timestamp_.exchange(0, std::memory_order_relaxed);
+    if (trigger != 0){
+        marker.timestamp = trigger;
+    }
+    write_entry(marker, text.data());
+    for (const FlightRecord& record : records){
+        write_entry(record.entry, record.payload);
+    }
+    if (!compressor_){
+        flush_pending();
+    }
+}
+
+// Index entries are written once their segment is complete (plain output only).
+void Logger::close_index_segment(){
+    if (!index_ || compressor_ || records_since_index_ == 0){
+        return;
+    }
+    index_->add(index_first_ts_, index_last_ts_, last_index_offset_);
+    records_since_index_ = 0;
+    index_first_ts_ = UINT64_MAX;
+    index_last_ts_ = 0;
+}
+
+void Logger::flush_pending(){
+    if (pending_first_ts_ == UINT64_MAX){
+        return;  // nothing but stream preamble so far
+    }
+
+    if (compressor_){
+        std::string block;
+        block.reserve(options_.compression_block_size + 1024);
+        block.swap(pending_);
+        compressor_->submit(std::move(block), pending_first_ts_, pending_last_ts_);
+        // Frames must decode on their own, so each one restarts the stream.
+        stream_start_pending_ = true;
+    } else {
+        log_file_.write(pending_.data(), pending_.size());
+        log_file_.flush();
+        file_offset_ += pending_.size();
+        pending_.clear();
+        if (index_){
+            index_->flush();
+        }
+    }
+    pending_first_ts_ = UINT64_MAX;
+    pending_last_ts_ = 0;
+}
+
+// Fires each watermark once on the way up; a level re-arms after occupancy
+// falls below half its threshold so a ring hovering at the line does not spam.
+size_t Logger::update_watermark_level(){
+    size_t occupancy = ring_->size();
+
+    while (watermark_level_ < watermark_thresholds_.size() &&
+           occupancy >= watermark_thresholds_[watermark_level_]){
+        watermark_hits_[watermark_level_].fetch_add(1, std::memory_order_relaxed);
+        if (options_.on_watermark){
+            options_.on_watermark(watermark_level_, occupancy, LogRing::capacity());
+        }
+        watermark_level_++;
+    }
+
+    while (watermark_level_ > 0 &&
+           occupancy < watermark_thresholds_[watermark_level_ - 1] / 2){
+        watermark_level_--;
+    }
+
+    return watermark_level_;
 }
 
 uint64_t Logger::get_timestamp_ns(){
@@ -71,8 +692,3 @@ uint64_t Logger::get_timestamp_ns(){
     auto duration = now.time_since_epoch();
     return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
 }
-
-std::string Logger::format_log_entry(const LogEntry& entry){
-
-    return "[" + std::to_string(entry.timestamp) + "] " + std::string(entry.message, entry.length);
-}
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "number_format.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t POW10[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull,
+};
+
+constexpr char DIGIT_PAIRS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes exactly `digits` digits of v ending at out + digits.
+inline void write_digits(char* out, uint64_t v, int digits){
+    char* p = out + digits;
+    while (v >= 100){
+        uint64_t q = v / 100;
+        std::memcpy(p -= 2, DIGIT_PAIRS + 2 * (v - q * 100), 2);
+        v = q;
+    }
+    if (v >= 10){
+        std::memcpy(p -= 2, DIGIT_PAIRS + 2 * v, 2);
+    } else {
+        *--p = static_cast<char>('0' + v);
+    }
+    while (p > out){
+        *--p = '0';     // only reached when padding to a fixed width
+    }
+}
+
+using uint128 = unsigned __int128;
+
+// ---- Schubfach (R. Giulietti, "The Schubfach way to render doubles") ----
+
+constexpr int POW10_MIN = -292;
+constexpr int POW10_MAX = 326;
+
+inline int floor_log2_pow10(int e){return (e * 1741647) >> 19;}
+inline int floor_log10_pow2(int e){return (e * 1262611) >> 22;}
+inline int floor_log10_three_quarters_pow2(int e){return (e * 1262611 - 524031) >> 22;}
+
+// g(k) = floor(10^k * 2^-r) + 1 with r = floor_log2_pow10(k) + 1 - 128, so
+// g lies in [2^127, 2^128). Computed once with a small bignum instead of
+// shipping 619 pairs of 64-bit constants.
+class Pow10Table {
+    public:
+        Pow10Table(){
+            // k in [0, 38]: 10^k fits in 128 bits and g is exact before the +1
+            uint128 p = 1;
+            for (int k = 0; k <= 38; k++, p *= 10){
+                g_[k - POW10_MIN] = (p << (127 - floor_log2_pow10(k))) + 1;
+            }
+
+            // k > 38: top 128 bits of 10^k
+            BigNum big;
+            big.w[0] = 1;
+            for (int k = 1; k <= POW10_MAX; k++){
+                big.mul10();
+                if (k > 38){
+                    g_[k - POW10_MIN] = big.bits(floor_log2_pow10(k) - 127) + 1;
+                }
+            }
+
+            // k < 0: floor(2^A / 10^-k) for a fixed A, then shifted down to the
+            // wanted exponent (floor of a floor is the floor of the quotient)
+            constexpr int A = 1200;
+            BigNum inv;
+            inv.w[A / 32] = 1u << (A % 32);
+            for (int k = -1; k >= POW10_MIN; k--){
+                inv.div10();
+                g_[k - POW10_MIN] = inv.bits(A - (127 - floor_log2_pow10(k))) + 1;
+            }
+        }
+
+        uint128 operator[](int k) const {return g_[k - POW10_MIN];}
+
+    private:
+        struct BigNum {
+            static constexpr int WORDS = 40;
+            uint32_t w[WORDS] = {};
+
+            void mul10(){
+                uint64_t carry = 0;
+                for (int i = 0; i < WORDS; i++){
+                    uint64_t x = uint64_t(w[i]) * 10 + carry;
+                    w[i] = static_cast<uint32_t>(x);
+                    carry = x >> 32;
+                }
+            }
+            void div10(){
+                uint64_t rem = 0;
+                for (int i = WORDS - 1; i >= 0; i--){
+                    uint64_t x = (rem << 32) | w[i];
+                    w[i] = static_cast<uint32_t>(x / 10);
+                    rem = x % 10;
+                }
+            }
+            // Bits [shift, shift + 128).
+            uint128 bits(int shift) const {
+                int j = shift / 32, off = shift % 32;
+                uint128 v = 0;
+                for (int i = 3; i >= 0; i--){
+                    v = (v << 32) | w[j + i];
+                }
+                if (off != 0){
+                    v = (v >> off) | (uint128(w[j + 4]) << (128 - off));
+                }
+                return v;
+            }
+        };
+
+        uint128 g_[POW10_MAX - POW10_MIN + 1];
+};
+
+const Pow10Table& pow10_table(){
+    static const Pow10Table table;
+    return table;
+}
+
+// (g * cp) >> 128, with the discarded bits folded into the lowest bit.
+inline uint64_t round_to_odd(uint128 g, uint64_t cp){
+    uint128 x = uint128(static_cast<uint64_t>(g)) * cp;
+    uint128 y = uint128(static_cast<uint64_t>(g >> 64)) * cp + (x >> 64);
+    return static_cast<uint64_t>(y >> 64) | (static_cast<uint64_t>(y) > 1);
+}
+
+struct Decimal {
+    uint64_t digits;
+    int exponent;
+};
+
+// Shortest decimal in the rounding interval of the double with the given
+// IEEE fields (not zero, not inf/nan); the closest one when there is a choice.
+Decimal to_decimal(uint64_t ieee_significand, uint32_t ieee_exponent){
+    constexpr uint64_t HIDDEN_BIT = uint64_t(1) << 52;
+    constexpr int EXPONENT_BIAS = 1023 + 52;
+
+    uint64_t c;
+    int q;
+    if (ieee_exponent != 0){
+        c = HIDDEN_BIT | ieee_significand;
+        q = static_cast<int>(ieee_exponent) - EXPONENT_BIAS;
+        // Small integers are exact
+        if (q <= 0 && -q < 53 && (c & ((uint64_t(1) << -q) - 1)) == 0){
+            return {c >> -q, 0};
+        }
+    } else {
+        c = ieee_significand;
+        q = 1 - EXPONENT_BIAS;
+    }
+
+    bool is_even = (c % 2) == 0;
+    bool lower_boundary_is_closer = ieee_significand == 0 && ieee_exponent > 1;
+
+    uint64_t cbl = 4 * c - 2 + lower_boundary_is_closer;
+    uint64_t cb = 4 * c;
+    uint64_t cbr = 4 * c + 2;
+
+    int k = lower_boundary_is_closer ? floor_log10_three_quarters_pow2(q) : floor_log10_pow2(q);
+    int h = q + floor_log2_pow10(-k) + 1;
+
+    uint128 g = pow10_table()[-k];
+    uint64_t vbl = round_to_odd(g, cbl << h);
+    uint64_t vb = round_to_odd(g, cb << h);
+    uint64_t vbr = round_to_odd(g, cbr << h);
+
+    uint64_t lower = vbl + !is_even;
+    uint64_t upper = vbr - !is_even;
+
+    uint64_t s = vb / 4;
+    if (s >= 10){
+        // One digit shorter, if exactly one of its neighbours is in range
+        uint64_t sp = s / 10;
+        bool up_inside = lower <= 40 * sp;
+        bool wp_inside = 40 * sp + 40 <= upper;
+        if (up_inside != wp_inside){
+            return {sp + wp_inside, k + 1};
+        }
+    }
+
+    bool u_inside = lower <= 4 * s;
+    bool w_inside = 4 * s + 4 <= upper;
+    if (u_inside != w_inside){
+        return {s + w_inside, k};
+    }
+
+    uint64_t mid = 4 * s + 2;
+    bool round_up = vb > mid || (vb == mid && (s & 1) != 0);
+    return {s + round_up, k};
+}
+
+} // namespace
+
+int decimal_digits(uint64_t v){
+    int bits = 64 - __builtin_clzll(v | 1);
+    int t = (bits * 1233) >> 12;     // floor(bits * log10(2)), off by at most one
+    return t + (v >= POW10[t]) + (v == 0);
+}
+
+char* format_uint(char* out, uint64_t v){
+    int digits = decimal_digits(v);
+    write_digits(out, v, digits);
+    return out + digits;
+}
+
+char* format_int(char* out, int64_t v){
+    uint64_t u = static_cast<uint64_t>(v);
+    if (v < 0){
+        *out++ = '-';
+        u = 0 - u;
+    }
+    return format_uint(out, u);
+}
+
+char* format_double(char* out, double v){
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    if (bits >> 63){
+        *out++ = '-';
+    }
+    uint64_t ieee_significand = bits & ((uint64_t(1) << 52) - 1);
+    uint32_t ieee_exponent = static_cast<uint32_t>(bits >> 52) & 0x7ff;
+    if (ieee_exponent == 0 && ieee_significand == 0){
+        *out++ = '0';
+        return out;
+    }
+
+    Decimal d = to_decimal(ieee_significand, ieee_exponent);
+    while (d.digits % 10 == 0){
+        d.digits /= 10;
+        d.exponent++;
+    }
+
+    char digits[20];
+    int n = decimal_digits(d.digits);
+    write_digits(digits, d.digits, n);
+
+    // value = digits * 10^exponent = d.ddd * 10^sci
+    int sci = n - 1 + d.exponent;
+    int sci_abs = sci < 0 ? -sci : sci;
+    int sci_len = n + (n > 1) + 2 + (sci_abs >= 100 ? 3 : 2);
+    int fixed_len = d.exponent >= 0 ? n + d.exponent : sci >= 0 ? n + 1 : n + 1 - sci;
+
+    if (fixed_len <= sci_len){
+        if (d.exponent > 0){
+            // Trailing zeros cost as much as real digits, and std::to_chars
+            // breaks length ties by closeness: print the exact integer
+            // (below 10^22 here, since fixed only wins for short exponents).
+            uint64_t c = ieee_significand | (uint64_t(1) << 52);
+            int q = static_cast<int>(ieee_exponent) - 1075;
+            uint128 x = q >= 0 ? uint128(c) << q : uint128(c >> -q);
+            if (x >> 64 == 0){
+                return format_uint(out, static_cast<uint64_t>(x));
+            }
+            out = format_uint(out, static_cast<uint64_t>(x / POW10[19]));
+            write_digits(out, static_cast<uint64_t>(x % POW10[19]), 19);
+            return out + 19;
+        }
+        if (d.exponent == 0){
+            std::memcpy(out, digits, n);
+            return out + n;
+        }
+        if (sci >= 0){
+            std::memcpy(out, digits, sci + 1);
+            out[sci + 1] = '.';
+            std::memcpy(out + sci + 2, digits + sci + 1, n - sci - 1);
+            return out + n + 1;
+        }
+        out[0] = '0';
+        out[1] = '.';
+        std::memset(out + 2, '0', -sci - 1);
+        std::memcpy(out + 1 - sci, digits, n);
+        return out + n + 1 - sci;
+    }
+
+    *out++ = digits[0];
+    if (n > 1){
+        *out++ = '.';
+        std::memcpy(out, digits + 1, n - 1);
+        out += n - 1;
+    }
+    *out++ = 'e';
+    *out++ = sci < 0 ? '-' : '+';
+    if (sci_abs >= 100){
+        *out++ = static_cast<char>('0' + sci_abs / 100);
+        sci_abs %= 100;
+    }
+    std::memcpy(out, DIGIT_PAIRS + 2 * sci_abs, 2);
+    return out + 2;
+}
+
+char* format_fixed(char* out, double v, int precision){
+    double a = std::fabs(v);
+    double scale = static_cast<double>(POW10[precision < 0 || precision > 9 ? 0 : precision]);
+    if (precision < 0 || precision > 9 || !(a * scale < 4503599627370496.0)){      // 2^52
+        return std::to_chars(out, out + FIXED_CHARS_MAX, v, std::chars_format::fixed, precision).ptr;
+    }
+
+    // a * scale == hi + lo exactly; hi < 2^52 so its fraction is exact and at
+    // least one ulp away from 0.5 unless it is 0.5, which lo then decides.
+    double hi = a * scale;
+    double lo = std::fma(a, scale, -hi);
+    double whole = std::floor(hi);
+    double frac = hi - whole;
+    uint64_t r = static_cast<uint64_t>(whole);
+    if (frac > 0.5 || (frac == 0.5 && (lo > 0 || (lo == 0 && (r & 1) != 0)))){
+        r++;
+    }
+
+    if (std::signbit(v)){
+        *out++ = '-';
+    }
+    uint64_t p = POW10[precision];
+    out = format_uint(out, r / p);
+    if (precision > 0){
+        *out++ = '.';
+        write_digits(out, r % p, precision);
+        out += precision;
+    }
+    return out;
+}
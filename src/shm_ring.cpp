@@ -0,0 +1,192 @@
+#include "shm_ring.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SHM_MAGIC[8] = {'A', 'L', 'S', 'H', 'M', 'R', 'N', 'G'};
+
+constexpr size_t align_up(size_t n, size_t alignment){
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+constexpr size_t ring_offset(){
+    return align_up(sizeof(ShmRingHeader), alignof(LogRing));
+}
+
+constexpr size_t pool_offset(){
+    return align_up(ring_offset() + sizeof(LogRing), alignof(SlabPool));
+}
+
+std::string error_text(const std::string& what, const std::string& segment){
+    return what + " " + segment + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+ShmRing::ShmRing(std::string segment, int fd, void* base, size_t size)
+    : segment_(std::move(segment)), fd_(fd), base_(base), size_(size),
+      header_(static_cast<ShmRingHeader*>(base)),
+      ring_(reinterpret_cast<LogRing*>(static_cast<char*>(base) + ring_offset())),
+      pool_(reinterpret_cast<SlabPool*>(static_cast<char*>(base) + pool_offset())) {}
+
+ShmRing::~ShmRing(){
+    ::munmap(base_, size_);
+    if (fd_ >= 0){
+        ::close(fd_);
+    }
+}
+
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name){
+    std::string clean = name;
+    for (char& c : clean){
+        if (c == '/'){
+            c = '_';
+        }
+    }
+    // A name can still exist after its ring closed (logd has not drained it)
+    // or after a dead process with our pid left it behind: never reuse one,
+    // take the next sequence number instead.
+    static std::atomic<uint64_t> sequence{0};
+    std::string segment, path;
+    int fd;
+    do {
+        segment = SHM_RING_PREFIX + clean + "." + std::to_string(::getpid()) + "." + std::to_string(sequence++);
+        path = "/" + segment;
+        fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    } while (fd < 0 && errno == EEXIST);
+    if (fd < 0){
+        throw std::runtime_error(error_text("Failed to create shared memory", segment));
+    }
+
+    size_t size = pool_offset() + sizeof(SlabPool);
+    if (::ftruncate(fd, size) != 0){
+        ::close(fd);
+        ::shm_unlink(path.c_str());
+        throw std::runtime_error(error_text("Failed to size shared memory", segment));
+    }
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED){
+        ::shm_unlink(path.c_str());
+        throw std::runtime_error(error_text("Failed to map shared memory", segment));
+    }
+
+    auto* header = new (base) ShmRingHeader();
+    std::memcpy(header->magic, SHM_MAGIC, sizeof(SHM_MAGIC));
+    header->version = SHM_RING_VERSION;
+    header->header_size = sizeof(ShmRingHeader);
+    header->entry_size = sizeof(LogEntry);
+    header->capacity = LogRing::capacity();
+    header->ring_offset = ring_offset();
+    header->ring_size = sizeof(LogRing);
+    header->pool_offset = pool_offset();
+    header->pool_size = sizeof(SlabPool);
+    header->producer_pid = ::getpid();
+    header->dropped.store(0, std::memory_order_relaxed);
+    std::strncpy(header->name, name.c_str(), sizeof(header->name) - 1);
+    new (static_cast<char*>(base) + ring_offset()) LogRing();
+    new (static_cast<char*>(base) + pool_offset()) SlabPool();
+
+    // Consumers only attach once the layout is complete.
+    header->state.store(static_cast<uint32_t>(ShmRingState::Live), std::memory_order_release);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(segment, -1, base, size));
+}
+
+std::unique_ptr<ShmRing> ShmRing::attach(const std::string& segment){
+    std::string path = "/" + segment;
+    int fd = ::shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0){
+        throw std::runtime_error(error_text("Failed to open shared memory", segment));
+    }
+    // The ring is single-consumer: a second logd must not drain it too.
+    if (::flock(fd, LOCK_EX | LOCK_NB) != 0){
+        ::close(fd);
+        throw std::runtime_error("Log ring already has a consumer: " + segment);
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)){
+        ::close(fd);
+        throw std::runtime_error("Shared memory segment too small: " + segment);
+    }
+    size_t size = st.st_size;
+    void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED){
+        ::close(fd);
+        throw std::runtime_error(error_text("Failed to map shared memory", segment));
+    }
+    std::unique_ptr<ShmRing> shm(new ShmRing(segment, fd, base, size));
+
+    const ShmRingHeader& h = *shm->header_;
+    if (std::memcmp(h.magic, SHM_MAGIC, sizeof(SHM_MAGIC)) != 0){
+        throw std::runtime_error("Not a log ring: " + segment);
+    }
+    if (h.state.load(std::memory_order_acquire) == static_cast<uint32_t>(ShmRingState::Creating)){
+        throw std::runtime_error("Log ring still being created: " + segment);
+    }
+    if (h.version != SHM_RING_VERSION || h.header_size != sizeof(ShmRingHeader) ||
+        h.entry_size != sizeof(LogEntry) || h.capacity != LogRing::capacity() ||
+        h.ring_offset != ring_offset() || h.ring_size != sizeof(LogRing) ||
+        h.pool_offset != pool_offset() || h.pool_size != sizeof(SlabPool) ||
+        size < h.pool_offset + h.pool_size){
+        throw std::runtime_error("Incompatible log ring layout (version " + std::to_string(h.version) +
+                                 "): " + segment);
+    }
+    return shm;
+}
+
+std::vector<std::string> ShmRing::list(){
+    std::vector<std::string> segments;
+    DIR* dir = ::opendir("/dev/shm");
+    if (!dir){
+        return segments;
+    }
+    size_t prefix_len = std::strlen(SHM_RING_PREFIX);
+    while (dirent* entry = ::readdir(dir)){
+        if (std::strncmp(entry->d_name, SHM_RING_PREFIX, prefix_len) == 0){
+            segments.emplace_back(entry->d_name);
+        }
+    }
+    ::closedir(dir);
+    return segments;
+}
+
+void ShmRing::mark_closed(uint64_t dropped){
+    header_->dropped.store(dropped, std::memory_order_relaxed);
+    header_->state.store(static_cast<uint32_t>(ShmRingState::Closed), std::memory_order_release);
+}
+
+bool ShmRing::producer_alive() const{
+    pid_t pid = static_cast<pid_t>(header_->producer_pid);
+    return ::kill(pid, 0) == 0 || errno == EPERM;
+}
+
+void ShmRing::unlink(){
+    std::string path = "/" + segment_;
+    if (fd_ >= 0){
+        int current = ::shm_open(path.c_str(), O_RDONLY, 0);
+        if (current < 0){
+            return;
+        }
+        struct stat ours, theirs;
+        bool same = ::fstat(fd_, &ours) == 0 && ::fstat(current, &theirs) == 0 &&
+                    ours.st_dev == theirs.st_dev && ours.st_ino == theirs.st_ino;
+        ::close(current);
+        if (!same){
+            return;
+        }
+    }
+    ::shm_unlink(path.c_str());
+}
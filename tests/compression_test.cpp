@@ -0,0 +1,131 @@
+#include <iostream>
+#include <cassert>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../include/compression.hpp"
+#include "../include/logger.hpp"
+
+static std::string round_trip(const std::string& input) {
+    std::vector<char> compressed(lz4_compress_bound(input.size()));
+    size_t n = lz4_compress_block(input.data(), input.size(), compressed.data());
+    assert(n <= compressed.size());
+
+    std::string output(input.size(), '\0');
+    long m = lz4_decompress_block(compressed.data(), n, &output[0], output.size());
+    assert(m == static_cast<long>(input.size()));
+    return output;
+}
+
+void test_block_round_trip() {
+    assert(round_trip("").empty());
+    assert(round_trip("a") == "a");
+    assert(round_trip("short message") == "short message");
+
+    std::string repetitive(100000, 'x');
+    assert(round_trip(repetitive) == repetitive);
+
+    std::string lines;
+    for (int i = 0; i < 5000; i++) {
+        lines += "[1700000000" + std::to_string(123456789 + i * 37) + "] Order " +
+                 std::to_string(i) + " filled px=101.25 qty=300\n";
+    }
+    assert(round_trip(lines) == lines);
+
+    std::mt19937 rng(42);
+    std::string noise(70000, '\0');
+    for (auto& c : noise) c = static_cast<char>(rng());
+    assert(round_trip(noise) == noise);
+
+    std::cout << "✓ test_block_round_trip passed\n";
+}
+
+void test_decompress_rejects_garbage() {
+    std::string lines(4096, 'y');
+    std::vector<char> compressed(lz4_compress_bound(lines.size()));
+    size_t n = lz4_compress_block(lines.data(), lines.size(), compressed.data());
+
+    // Output buffer too small
+    std::string output(100, '\0');
+    assert(lz4_decompress_block(compressed.data(), n, &output[0], output.size()) < 0);
+
+    // Offset pointing before the start of the output
+    const char bad[] = {0x10, 'a', 0x05, 0x00};
+    assert(lz4_decompress_block(bad, sizeof(bad), &output[0], output.size()) < 0);
+
+    std::cout << "✓ test_decompress_rejects_garbage passed\n";
+}
+
+void test_frames() {
+    std::string first = "alpha alpha alpha alpha alpha alpha alpha\n";
+    std::string second(1000, 'z');
+
+    std::string encoded;
+    encode_frame(first.data(), first.size(), 10, 20, encoded);
+    encode_frame(second.data(), second.size(), 30, 40, encoded);
+
+    std::istringstream in(encoded);
+    FrameHeader header;
+    std::string raw;
+
+    assert(read_frame(in, header, raw));
+    assert(raw == first && header.first_timestamp == 10 && header.last_timestamp == 20);
+    assert(read_frame(in, header, raw));
+    assert(raw == second && header.first_timestamp == 30 && header.last_timestamp == 40);
+    assert(header.stored_size < second.size());
+    assert(!read_frame(in, header, raw));
+
+    std::cout << "✓ test_frames passed\n";
+}
+
+void test_compressed_logger() {
+    const char* path = "test_compressed.log";
+    std::remove(path);
+
+    constexpr int NUM_MESSAGES = 500;
+    {
+        LoggerOptions options;
+        options.compression = Compression::LZ4;
+        options.compression_block_size = 4096;  // force several frames
+        Logger logger(path, options);
+        for (int i = 0; i < NUM_MESSAGES; i++) {
+            logger.log("Compressed message " + std::to_string(i));
+        }
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    FrameHeader header;
+    std::string raw;
+    std::string text;
+    int frames = 0;
+    while (read_frame(in, header, raw)) {
+        assert(header.first_timestamp <= header.last_timestamp);
+        text += raw;
+        frames++;
+    }
+    assert(frames > 1);
+
+    std::istringstream lines(text);
+    std::string line;
+    int count = 0;
+    while (std::getline(lines, line)) {
+        assert(line.find("Compressed message " + std::to_string(count)) != std::string::npos);
+        count++;
+    }
+    assert(count == NUM_MESSAGES);
+
+    std::cout << "✓ test_compressed_logger passed (" << frames << " frames)\n";
+}
+
+int main() {
+    std::cout << "Running compression tests...\n\n";
+
+    test_block_round_trip();
+    test_decompress_rejects_garbage();
+    test_frames();
+    test_compressed_logger();
+
+    std::cout << "\n✅ All compression tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include "../include/log_format.hpp"
+#include "../include/logger.hpp"
+
+// An entry with its payload alongside, as the consumer sees it after resolving the slab.
+struct TestEntry {
+    LogEntry entry;
+    char payload[512];
+};
+
+static TestEntry make_kv(uint64_t ts, const char* event, std::initializer_list<KvField> fields) {
+    TestEntry e;
+    e.entry.timestamp = ts;
+    e.entry.kind = EntryKind::KeyValue;
+    e.entry.level = LogLevel::Info;
+    e.entry.slab = SLAB_NONE;
+    e.entry.length = encode_kv(event, fields, e.payload, sizeof(e.payload));
+    return e;
+}
+
+static TestEntry make_text(uint64_t ts, const char* text) {
+    TestEntry e;
+    e.entry.timestamp = ts;
+    e.entry.kind = EntryKind::Text;
+    e.entry.level = LogLevel::Info;
+    e.entry.slab = SLAB_NONE;
+    e.entry.length = std::strlen(text);
+    std::memcpy(e.payload, text, e.entry.length);
+    return e;
+}
+
+static void format(LogFormatter& formatter, const TestEntry& e, std::string& out) {
+    formatter.format(e.entry, e.payload, out);
+}
+
+void test_text_and_json() {
+    TestEntry fill = make_kv(42, "fill", {{"px", 101.25}, {"qty", 300}, {"venue", "XNAS"}, {"ok", true}});
+
+    std::string out;
+    LogFormatter text(LogFormat::Text);
+    format(text, fill, out);
+    assert(out == "[42] fill px=101.25 qty=300 venue=XNAS ok=true\n");
+
+    out.clear();
+    LogFormatter json(LogFormat::Json);
+    format(json, fill, out);
+    assert(out == "{\"ts\":42,\"event\":\"fill\",\"px\":101.25,\"qty\":300,\"venue\":\"XNAS\",\"ok\":true}\n");
+
+    out.clear();
+    format(json, make_text(7, "say \"hi\"\n"), out);
+    assert(out == "{\"ts\":7,\"msg\":\"say \\\"hi\\\"\\n\"}\n");
+
+    // INFO is implied; other levels are tagged
+    TestEntry warn = make_text(9, "disk low");
+    warn.entry.level = LogLevel::Warn;
+    out.clear();
+    format(text, warn, out);
+    assert(out == "[9] WARN disk low\n");
+    out.clear();
+    format(json, warn, out);
+    assert(out == "{\"ts\":9,\"level\":\"WARN\",\"msg\":\"disk low\"}\n");
+
+    // Fixed-precision doubles (prices), rounded on the exact binary value
+    TestEntry quote = make_kv(11, "quote", {{"bid", 101.125}, {"ask", 0.1 + 0.2}, {"qty", 5}});
+    out.clear();
+    LogFormatter text_px(LogFormat::Text, EscapeMode::Raw, 2);
+    format(text_px, quote, out);
+    assert(out == "[11] quote bid=101.12 ask=0.30 qty=5\n");
+    out.clear();
+    format(text, quote, out);
+    assert(out == "[11] quote bid=101.125 ask=0.30000000000000004 qty=5\n");
+
+    std::cout << "✓ test_text_and_json passed\n";
+}
+
+void test_binary_round_trip() {
+    LogFormatter binary(LogFormat::Binary);
+    std::string out;
+    binary.begin(out);
+    format(binary, make_kv(1, "fill", {{"px", 101.25}, {"qty", 300}}), out);
+    size_t first_fill = out.size();
+    format(binary, make_text(2, "plain"), out);
+    size_t before_second_fill = out.size();
+    TestEntry error_fill = make_kv(3, "fill", {{"px", 99.5}, {"qty", 100}});
+    error_fill.entry.level = LogLevel::Error;
+    format(binary, error_fill, out);
+    size_t second_fill = out.size() - before_second_fill;
+    format(binary, make_kv(4, "cancel", {{"id", uint64_t(18446744073709551615ull)}, {"reason", "user"}}), out);
+
+    // The schema is described once; later records carry only id, timestamp and values
+    assert(second_fill == 1 + 2 + 8 + 1 + 8 + 8);
+    assert(first_fill - 4 > second_fill);
+
+    std::vector<DecodedRecord> records;
+    BinaryLogDecoder decoder;
+    size_t used = decoder.decode(out.data(), out.size(), [&](const DecodedRecord& r) { records.push_back(r); });
+    assert(used == out.size());
+    assert(records.size() == 4);
+
+    assert(!records[0].is_text && records[0].text == "fill" && records[0].timestamp == 1);
+    assert(records[0].fields[0].first == "px" && records[0].fields[0].second.d == 101.25);
+    assert(records[0].fields[1].first == "qty" && records[0].fields[1].second.i == 300);
+    assert(records[1].is_text && records[1].text == "plain");
+    assert(records[2].fields[0].second.d == 99.5 && records[2].level == LogLevel::Error);
+    assert(records[1].level == LogLevel::Info);
+    assert(records[3].fields[0].second.u == 18446744073709551615ull);
+    assert(records[3].fields[1].second.s == "user");
+
+    // Truncated input decodes only whole records
+    BinaryLogDecoder partial;
+    size_t count = 0;
+    size_t consumed = partial.decode(out.data(), out.size() - 3, [&](const DecodedRecord&) { count++; });
+    assert(count == 3 && consumed < out.size() - 3);
+
+    std::string json;
+    append_json_record(records[0], json);
+    assert(json == "{\"ts\":1,\"event\":\"fill\",\"px\":101.25,\"qty\":300}\n");
+
+    std::cout << "✓ test_binary_round_trip passed\n";
+}
+
+void test_kv_truncation() {
+    std::string big(1000, 'x');
+    TestEntry entry = make_kv(1, "big", {{"a", 1}, {"blob", big}, {"b", 2}});
+    assert(entry.entry.length <= sizeof(entry.payload));
+
+    std::string out;
+    LogFormatter text(LogFormat::Text);
+    format(text, entry, out);
+    assert(out.compare(0, 17, "[1] big a=1 blob=") == 0);
+    assert(out.find(" b=2") == std::string::npos);
+
+    std::cout << "✓ test_kv_truncation passed\n";
+}
+
+void test_logger_json_output() {
+    const char* path = "test_kv.log";
+    std::remove(path);
+    {
+        LoggerOptions options;
+        options.format = LogFormat::Json;
+        Logger logger(path, options);
+        logger.log_kv("fill", {{"px", 101.25}, {"qty", 300}});
+        logger.log("started");
+    }
+
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    assert(line.find("\"event\":\"fill\",\"px\":101.25,\"qty\":300}") != std::string::npos);
+    std::getline(in, line);
+    assert(line.find("\"msg\":\"started\"}") != std::string::npos);
+
+    std::cout << "✓ test_logger_json_output passed\n";
+}
+
+void test_escape_scan() {
+    // Every escape position, in every lane, across every SIMD tail length
+    const char specials[] = {'\n', '\0', '\x1f', '\\', '"', '\x7f', '\x80', ' '};
+    for (size_t n = 0; n <= 80; n++) {
+        for (size_t pos = 0; pos < n; pos++) {
+            for (char c : specials) {
+                std::string s(n, 'a');
+                s[pos] = c;
+                for (EscapeMode mode : {EscapeMode::Raw, EscapeMode::Text, EscapeMode::Json}) {
+                    assert(escape_scan(s.data(), n, mode) == escape_scan_scalar(s.data(), n, mode));
+                }
+            }
+        }
+    }
+    assert(escape_scan_scalar("a\"b", 3, EscapeMode::Json) == 1);
+    assert(escape_scan_scalar("a\"b", 3, EscapeMode::Text) == 3);
+    assert(escape_scan_scalar("a\nb", 3, EscapeMode::Raw) == 3);
+
+    // Random bytes, mostly clean
+    uint32_t seed = 12345;
+    for (int round = 0; round < 2000; round++) {
+        std::string s(1 + round % 200, 'x');
+        for (char& c : s) {
+            seed = seed * 1103515245 + 12345;
+            c = (seed >> 16) % 16 == 0 ? static_cast<char>(seed >> 24) : 'x';
+        }
+        for (EscapeMode mode : {EscapeMode::Text, EscapeMode::Json}) {
+            assert(escape_scan(s.data(), s.size(), mode) == escape_scan_scalar(s.data(), s.size(), mode));
+        }
+    }
+
+    std::cout << "✓ test_escape_scan passed (" << escape_isa() << ")\n";
+}
+
+void test_escaped_output() {
+    const char msg[] = "line1\nline2\t\"q\" back\\slash \x01 end";
+    std::string out;
+    append_escaped(out, msg, sizeof(msg) - 1, EscapeMode::Text);
+    assert(out == "line1\\nline2\\t\"q\" back\\\\slash \\x01 end");
+    out.clear();
+    append_escaped(out, msg, sizeof(msg) - 1, EscapeMode::Json);
+    assert(out == "line1\\nline2\\t\\\"q\\\" back\\\\slash \\u0001 end");
+    out.clear();
+    append_escaped(out, msg, sizeof(msg) - 1, EscapeMode::Raw);
+    assert(out == msg);
+
+    // Per-sink: the text sink keeps one record per line once escaping is on
+    TestEntry multi = make_text(5, "first\nsecond");
+    TestEntry kv = make_kv(6, "note", {{"why", "a\nb"}});
+    out.clear();
+    LogFormatter raw(LogFormat::Text);
+    format(raw, multi, out);
+    assert(out == "[5] first\nsecond\n");
+    out.clear();
+    LogFormatter escaped(LogFormat::Text, EscapeMode::Text);
+    format(escaped, multi, out);
+    format(escaped, kv, out);
+    assert(out == "[5] first\\nsecond\n[6] note why=a\\nb\n");
+    out.clear();
+    LogFormatter json(LogFormat::Json, EscapeMode::Raw);   // JSON ignores the text mode
+    format(json, kv, out);
+    assert(out == "{\"ts\":6,\"event\":\"note\",\"why\":\"a\\nb\"}\n");
+
+    std::cout << "✓ test_escaped_output passed\n";
+}
+
+int main() {
+    std::cout << "Running log format tests...\n\n";
+
+    test_text_and_json();
+    test_binary_round_trip();
+    test_kv_truncation();
+    test_logger_json_output();
+    test_escape_scan();
+    test_escaped_output();
+
+    std::cout << "\n✅ All log format tests passed!\n";
+    return 0;
+}
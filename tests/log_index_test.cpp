@@ -0,0 +1,254 @@
+#include <iostream>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <vector>
+#include "../include/compression.hpp"
+#include "../include/log_index.hpp"
+#include "../include/logger.hpp"
+
+static std::string read_file(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void test_seek_and_stop() {
+    const char* path = "test_index_unit.idx";
+    std::remove(path);
+    {
+        LogIndexWriter writer(path, 0);
+        writer.add(100, 200, 0);
+        writer.add(200, 300, 1000);
+        writer.add(300, 400, 2000);
+    }
+
+    LogIndexReader reader(path);
+    assert(reader.size() == 3 && !reader.framed());
+    assert(reader.seek_offset(50) == 0);      // before the first entry
+    assert(reader.seek_offset(100) == 0);
+    assert(reader.seek_offset(200) == 0);     // the 100 block may end with 200s
+    assert(reader.seek_offset(250) == 1000);  // range may start inside the 200 block
+    assert(reader.seek_offset(999) == 2000);  // past every segment: scan the last one
+    assert(reader.stop_offset(150) == 1000);
+    assert(reader.stop_offset(200) == 2000);
+    assert(reader.stop_offset(300) == UINT64_MAX);
+
+    // Reopening appends without a second header; a different layout is rejected
+    {
+        LogIndexWriter writer(path, 0);
+        writer.add(400, 500, 3000);
+    }
+    assert(LogIndexReader(path).size() == 4);
+    bool threw = false;
+    try {
+        LogIndexWriter writer(path, INDEX_FRAMED);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    std::cout << "✓ test_seek_and_stop passed\n";
+}
+
+// A segment boundary that falls inside a run of equal timestamps: scanning
+// from seek_offset must still see every record stamped exactly `from`.
+void test_seek_equal_timestamps() {
+    const char* path = "test_index_equal.idx";
+    std::remove(path);
+    const uint64_t stamps[] = {100, 200, 200, 200, 200, 300};
+    std::vector<uint64_t> offsets;
+    uint64_t offset = 0;
+    {
+        LogIndexWriter writer(path, 0);
+        for (size_t i = 0; i < 6; i++) {
+            offsets.push_back(offset);
+            if (i % 2 == 0) writer.add(stamps[i], stamps[i + 1], offset);  // segments of two records
+            offset += 10;
+        }
+    }
+
+    LogIndexReader reader(path);
+    assert(reader.size() == 3);
+    for (uint64_t from : {100, 150, 200, 250, 300}) {
+        uint64_t begin = reader.seek_offset(from);
+        for (size_t i = 0; i < 6; i++) {
+            if (stamps[i] >= from) assert(offsets[i] >= begin);
+        }
+    }
+    assert(reader.seek_offset(200) == 0);
+    assert(reader.stop_offset(200) == UINT64_MAX);
+
+    std::cout << "✓ test_seek_equal_timestamps passed\n";
+}
+
+// A segment holding older records than the ones before it (a flight-recorder
+// dump) widens both lookups instead of being skipped.
+void test_seek_out_of_order_segment() {
+    const char* path = "test_index_unordered.idx";
+    std::remove(path);
+    {
+        LogIndexWriter writer(path, 0);
+        writer.add(100, 200, 0);
+        writer.add(200, 300, 1000);
+        writer.add(50, 310, 2000);
+        writer.add(310, 400, 3000);
+    }
+
+    LogIndexReader reader(path);
+    assert(reader.seek_offset(60) == 0);
+    assert(reader.seek_offset(305) == 2000);
+    assert(reader.stop_offset(40) == 0);
+    assert(reader.stop_offset(150) == 3000);    // not 1000: the dump holds 50..310
+    assert(reader.stop_offset(310) == UINT64_MAX);
+
+    std::cout << "✓ test_seek_out_of_order_segment passed\n";
+}
+
+void test_plain_log_index() {
+    const char* path = "test_index.log";
+    std::remove(path);
+    std::remove(index_path_for(path).c_str());
+
+    LoggerOptions options;
+    options.write_index = true;
+    options.index_interval_records = 50;
+    {
+        Logger logger(path, options);
+        for (int i = 0; i < 500; i++) {
+            logger.log("Indexed message " + std::to_string(i));
+        }
+    }
+
+    std::string log = read_file(path);
+    LogIndexReader index(index_path_for(path));
+    assert(index.size() == 10);
+
+    for (size_t i = 0; i < index.size(); i++) {
+        uint64_t offset = index[i].offset;
+        assert(offset < log.size());
+        assert(log[offset] == '[');
+        assert(offset == 0 || log[offset - 1] == '\n');
+        assert(std::stoull(log.substr(offset + 1)) == index[i].first_timestamp);
+        assert(index[i].last_timestamp >= index[i].first_timestamp);
+        if (i > 0) assert(index[i].first_timestamp >= index[i - 1].last_timestamp);
+    }
+    std::string line = log.substr(index[3].offset, log.find('\n', index[3].offset) - index[3].offset);
+    assert(line.size() > 19 && line.compare(line.size() - 19, 19, "Indexed message 150") == 0);
+
+    std::cout << "✓ test_plain_log_index passed\n";
+}
+
+void test_compressed_log_index() {
+    const char* path = "test_index.log.lz4";
+    std::remove(path);
+    std::remove(index_path_for(path).c_str());
+
+    LoggerOptions options;
+    options.write_index = true;
+    options.compression = Compression::LZ4;
+    options.compression_block_size = 2048;
+    {
+        Logger logger(path, options);
+        for (int i = 0; i < 500; i++) {
+            logger.log("Compressed indexed message " + std::to_string(i));
+        }
+    }
+
+    std::string log = read_file(path);
+    LogIndexReader index(index_path_for(path));
+    assert(index.framed());
+    assert(index.size() > 1);
+
+    for (size_t i = 0; i < index.size(); i++) {
+        FrameHeader header;
+        std::memcpy(&header, log.data() + index[i].offset, sizeof(header));
+        assert(header.magic == FRAME_MAGIC);
+        assert(header.first_timestamp == index[i].first_timestamp);
+        assert(header.last_timestamp == index[i].last_timestamp);
+    }
+
+    std::cout << "✓ test_compressed_log_index passed (" << index.size() << " frames)\n";
+}
+
+// Lines stamped within [from, to], read through the index the way logquery does.
+static std::vector<std::string> query(const char* path, uint64_t from, uint64_t to) {
+    std::string log = read_file(path);
+    LogIndexReader index(index_path_for(path));
+    uint64_t begin = std::min<uint64_t>(index.seek_offset(from), log.size());
+    uint64_t stop = std::min<uint64_t>(index.stop_offset(to), log.size());
+    std::string text = log.substr(begin, stop - begin);
+    if (index.framed()) {
+        std::istringstream in(text);
+        FrameHeader header;
+        std::string raw;
+        text.clear();
+        while (read_frame(in, header, raw)) text += raw;
+    }
+
+    std::vector<std::string> lines;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        uint64_t ts = std::stoull(line.substr(1));
+        if (ts >= from && ts <= to) lines.push_back(line);
+    }
+    return lines;
+}
+
+void test_flight_recorder_dump_query(Compression compression) {
+    const char* path = compression == Compression::LZ4 ? "test_index_dump.log.lz4" : "test_index_dump.log";
+    std::remove(path);
+    std::remove(index_path_for(path).c_str());
+
+    LoggerOptions options;
+    options.write_index = true;
+    options.index_interval_records = 8;
+    options.compression = compression;
+    options.compression_block_size = 1024;
+    options.flight_recorder = true;
+    {
+        Logger logger(path, options);
+        for (int i = 0; i < 50; i++) {
+            logger.log("Info " + std::to_string(i));
+            logger.log(LogLevel::Debug, "Debug " + std::to_string(i));
+        }
+        logger.log_kv(LogLevel::Error, "order_rejected", {{"id", 7}});
+        for (int i = 0; i < 20; i++) {
+            logger.log("After " + std::to_string(i));
+        }
+    }
+
+    // Every line is found by a query for exactly its own timestamp
+    std::vector<std::string> all = query(path, 0, UINT64_MAX);
+    assert(all.size() == 50 + 1 + 1 + 50 + 20);
+    uint64_t error_ts = 0, marker_ts = 0;
+    for (const std::string& line : all) {
+        uint64_t ts = std::stoull(line.substr(1));
+        if (line.find("order_rejected") != std::string::npos) error_ts = ts;
+        if (line.find("flight recorder: 50 entries follow") != std::string::npos) marker_ts = ts;
+        std::vector<std::string> hits = query(path, ts, ts);
+        assert(std::find(hits.begin(), hits.end(), line) != hits.end());
+    }
+    assert(error_ts != 0 && marker_ts == error_ts);
+
+    std::cout << "✓ test_flight_recorder_dump_query passed ("
+              << (compression == Compression::LZ4 ? "lz4" : "plain") << ")\n";
+}
+
+int main() {
+    std::cout << "Running log index tests...\n\n";
+
+    test_seek_and_stop();
+    test_seek_equal_timestamps();
+    test_seek_out_of_order_segment();
+    test_plain_log_index();
+    test_compressed_log_index();
+    test_flight_recorder_dump_query(Compression::None);
+    test_flight_recorder_dump_query(Compression::LZ4);
+
+    std::cout << "\n✅ All log index tests passed!\n";
+    return 0;
+}
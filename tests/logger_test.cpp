@@ -1,7 +1,11 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <cassert>
+#include <fstream>
+#include <poll.h>
 #include "../include/logger.hpp"
+#include "../include/log_backend.hpp"
 
 int main() {
     std::cout << "Testing Logger...\n";
@@ -28,6 +32,409 @@ int main() {
         // Destructor will wait for all logs to be written
     }
     
+    {
+        // Test 3: Watermarks fire while the consumer catches up after a burst
+        std::cout << "Test 3: Occupancy watermarks\n";
+        std::atomic<int> callbacks{0};
+        LoggerOptions options;
+        options.watermarks = {0.5, 0.8, 0.95};
+        options.on_watermark = [&](size_t, size_t occupancy, size_t capacity) {
+            assert(occupancy <= capacity);
+            callbacks++;
+        };
+        Logger logger("test_watermark.log", options);
+
+        // Let the consumer go to sleep, then burst past every watermark
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        for (int i = 0; i < 1000; i++) {
+            logger.log("Burst " + std::to_string(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+        assert(logger.get_watermark_hits(0) >= 1);
+        assert(logger.get_watermark_hits(1) >= 1);
+        assert(logger.get_watermark_hits(2) >= 1);
+        assert(logger.get_watermark_hits(3) == 0);   // not configured
+        assert(callbacks.load() >= 3);
+    }
+
+    {
+        // Test 4: Staged producers publish in batches; nothing is lost on commit/destruction
+        std::cout << "Test 4: Thread-local staging\n";
+        std::remove("test_staged.log");
+        {
+            LoggerOptions options;
+            options.staging_capacity = 16;
+            options.staging_flush_interval = std::chrono::seconds(10);
+            Logger logger("test_staged.log", options);
+
+            for (int i = 0; i < 100; i++) {
+                logger.log("Staged " + std::to_string(i));
+            }
+            logger.commit();
+
+            std::thread other([&]() {
+                for (int i = 0; i < 10; i++) {
+                    logger.log("Other thread " + std::to_string(i));
+                }
+                // Left staged; published by the destructor
+            });
+            other.join();
+        }
+
+        std::ifstream in("test_staged.log");
+        std::string line;
+        int staged = 0, other = 0;
+        while (std::getline(in, line)) {
+            if (line.find("] Staged " + std::to_string(staged)) != std::string::npos) staged++;
+            else if (line.find("] Other thread ") != std::string::npos) other++;
+        }
+        assert(staged == 100);
+        assert(other == 10);
+
+        // One thread alternating between two staged loggers keeps both slots cached
+        std::remove("test_staged_a.log");
+        std::remove("test_staged_b.log");
+        {
+            LoggerOptions options;
+            options.staging_capacity = 16;
+            Logger a("test_staged_a.log", options);
+            Logger b("test_staged_b.log", options);
+            for (int i = 0; i < 100; i++) {
+                a.log("A " + std::to_string(i));
+                b.log("B " + std::to_string(i));
+            }
+        }
+        for (auto file : {std::make_pair("test_staged_a.log", "] A "), std::make_pair("test_staged_b.log", "] B ")}) {
+            std::ifstream alternating(file.first);
+            int count = 0;
+            while (std::getline(alternating, line)) {
+                if (line.find(file.second + std::to_string(count)) != std::string::npos) count++;
+            }
+            assert(count == 100);
+        }
+
+        // A thread that stages a few lines and then blocks: the consumer writes them
+        std::remove("test_staged_idle.log");
+        {
+            LoggerOptions options;
+            options.staging_capacity = 16;
+            options.staging_flush_interval = std::chrono::milliseconds(1);
+            options.idle_sleep = std::chrono::milliseconds(1);
+            Logger logger("test_staged_idle.log", options);
+            std::atomic<bool> release{false};
+            std::thread idle([&]() {
+                for (int i = 0; i < 3; i++) {
+                    logger.log("Before hang " + std::to_string(i));
+                }
+                while (!release.load()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                logger.log("After hang");
+            });
+
+            int seen = 0;
+            for (int attempt = 0; attempt < 200 && seen < 3; attempt++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                std::ifstream idle_log("test_staged_idle.log");
+                seen = 0;
+                while (std::getline(idle_log, line)) {
+                    if (line.find("] Before hang " + std::to_string(seen)) != std::string::npos) seen++;
+                }
+            }
+            assert(seen == 3);
+            release.store(true);
+            idle.join();
+        }
+        {
+            std::ifstream idle_log("test_staged_idle.log");
+            int before = 0, after = 0;
+            while (std::getline(idle_log, line)) {
+                if (line.find("] Before hang ") != std::string::npos) before++;
+                else if (line.find("] After hang") != std::string::npos) after++;
+            }
+            assert(before == 3 && after == 1);
+        }
+
+        PerThread<int> first, second;
+        for (int i = 0; i < 1000; i++) {
+            first.local()++;
+            second.local()++;
+        }
+        assert(first.local() == 1000 && second.local() == 1000);
+        assert(first.lookups() == 1 && second.lookups() == 1);
+    }
+
+    {
+        // Test 5: DEBUG stays in per-thread history until an ERROR dumps it, merged by time
+        std::cout << "Test 5: Flight recorder\n";
+        std::remove("test_flight.log");
+        {
+            LoggerOptions options;
+            options.flight_recorder = true;
+            options.flight_recorder_capacity = 64;
+            Logger logger("test_flight.log", options);
+
+            std::thread other([&]() {
+                for (int i = 0; i < 10; i++) {
+                    logger.log(LogLevel::Debug, "Other debug " + std::to_string(i));
+                }
+            });
+            other.join();
+            for (int i = 0; i < 100; i++) {
+                logger.log(LogLevel::Debug, "Debug " + std::to_string(i));
+            }
+            logger.log("Visible info");
+            logger.log_kv(LogLevel::Error, "order_rejected", {{"id", 7}});
+        }
+
+        std::ifstream in("test_flight.log");
+        std::string line;
+        bool in_dump = false;
+        int markers = 0, debug = 0, other = 0;
+        uint64_t last_ts = 0;
+        while (std::getline(in, line)) {
+            if (line.find("] flight recorder: 74 entries follow, 36 overwritten") != std::string::npos) {
+                markers++;
+                in_dump = true;
+                continue;
+            }
+            bool is_debug = line.find("] DEBUG ") != std::string::npos;
+            if (is_debug) {
+                assert(in_dump);
+                uint64_t ts = std::stoull(line.substr(1));
+                assert(ts >= last_ts);
+                last_ts = ts;
+                if (line.find("Other debug") != std::string::npos) other++;
+                else if (line.find("] DEBUG Debug " + std::to_string(36 + debug)) != std::string::npos) debug++;
+            } else {
+                in_dump = false;
+            }
+        }
+        assert(markers == 1);
+        assert(debug == 64);
+        assert(other == 10);
+    }
+
+    {
+        // Test 6: A noisy call site is collapsed/throttled and the suppressed counts are logged,
+        // including for a flood that never lets up
+        std::cout << "Test 6: Per-call-site rate limiting\n";
+        std::remove("test_limited.log");
+        LoggerOptions options;
+        options.suppressed_report_interval = std::chrono::hours(1);   // only on recovery or shutdown
+        {
+            Logger logger("test_limited.log", options);
+            auto feed = [&](const std::string& message) {
+                LOG_LIMITED(logger, LogLevel::Warn, 100, 5, message);
+            };
+
+            for (int i = 0; i < 10000; i++) {
+                feed("feed gap");
+            }
+            for (int i = 0; i < 1000; i++) {
+                feed("sequence " + std::to_string(i));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            feed("recovered");
+        }
+
+        std::ifstream in("test_limited.log");
+        std::string line;
+        int gaps = 0, sequences = 0, recovered = 0;
+        std::vector<uint64_t> counts;
+        while (std::getline(in, line)) {
+            if (line.find("] WARN feed gap") != std::string::npos) gaps++;
+            else if (line.find("] WARN sequence ") != std::string::npos) sequences++;
+            else if (line.find("] WARN recovered") != std::string::npos) recovered++;
+            else if (line.find("] WARN suppressed file=logger_test.cpp line=") != std::string::npos) {
+                counts.push_back(std::stoull(line.substr(line.find("count=") + 6)));
+            }
+        }
+        assert(gaps == 1);
+        assert(recovered == 1);
+        assert(sequences >= 4 && sequences < 1000);   // the burst of 5 includes "feed gap"
+        assert(counts.size() == 2);
+        assert(counts[0] == 9999);
+        assert(counts[1] == 1000u - sequences);
+
+        // Collects the admitted lines with `prefix` and the suppressed counts
+        auto tally = [](const char* path, const std::string& prefix, std::vector<uint64_t>& counts) {
+            std::ifstream in(path);
+            std::string line;
+            int admitted = 0;
+            while (std::getline(in, line)) {
+                if (line.find("] WARN " + prefix) != std::string::npos) admitted++;
+                else if (line.find("] WARN suppressed file=logger_test.cpp line=") != std::string::npos) {
+                    counts.push_back(std::stoull(line.substr(line.find("count=") + 6)));
+                }
+            }
+            return admitted;
+        };
+
+        // A flood that just stops is still reported, by the destructor
+        std::remove("test_limited_end.log");
+        {
+            Logger logger("test_limited_end.log", options);
+            for (int i = 0; i < 1000; i++) {
+                LOG_LIMITED(logger, LogLevel::Warn, 100, 5, "flood " + std::to_string(i));
+            }
+        }
+        counts.clear();
+        int floods = tally("test_limited_end.log", "flood ", counts);
+        assert(floods >= 5 && floods < 1000);
+        assert(counts.size() == 1 && counts[0] == 1000u - floods);
+
+        // ... or by the consumer once suppressed_report_interval has passed
+        std::remove("test_limited_timer.log");
+        {
+            LoggerOptions timed;
+            timed.manual_drain = true;
+            timed.suppressed_report_interval = std::chrono::milliseconds(10);
+            Logger logger("test_limited_timer.log", timed);
+            for (int i = 0; i < 1000; i++) {
+                LOG_LIMITED(logger, LogLevel::Warn, 100, 5, "tick " + std::to_string(i));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            logger.drain();
+
+            counts.clear();
+            int ticks = tally("test_limited_timer.log", "tick ", counts);
+            assert(ticks >= 5 && ticks < 1000);
+            assert(counts.size() == 1 && counts[0] == 1000u - ticks);
+        }
+        counts.clear();
+        tally("test_limited_timer.log", "tick ", counts);
+        assert(counts.size() == 1);   // nothing left over for the destructor
+
+        // Short-lived threads: each exited thread's final count is reported once, then dropped
+        std::remove("test_limited_threads.log");
+        {
+            LoggerOptions timed;
+            timed.manual_drain = true;
+            timed.suppressed_report_interval = std::chrono::milliseconds(10);
+            Logger logger("test_limited_threads.log", timed);
+            for (int t = 0; t < 20; t++) {
+                std::thread([&logger] {
+                    for (int i = 0; i < 100; i++) {
+                        LOG_LIMITED(logger, LogLevel::Warn, 100, 5, "burst " + std::to_string(i));
+                    }
+                }).join();
+                logger.drain();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            logger.drain();
+        }
+        counts.clear();
+        int bursts = tally("test_limited_threads.log", "burst ", counts);
+        uint64_t reported = 0;
+        for (uint64_t c : counts) reported += c;
+        assert(counts.size() == 20);
+        assert(reported == 2000u - bursts);
+    }
+
+    {
+        // Test 7: No internal thread; the application drains when the eventfd says so
+        std::cout << "Test 7: Manual drain with notify eventfd\n";
+        std::remove("test_manual.log");
+        auto readable = [](int fd) {
+            pollfd p{fd, POLLIN, 0};
+            return ::poll(&p, 1, 0) == 1;
+        };
+        {
+            LoggerOptions options;
+            options.manual_drain = true;
+            options.notify_threshold = 200;
+            Logger logger("test_manual.log", options);
+            assert(logger.notify_fd() >= 0);
+
+            for (int i = 0; i < 100; i++) {
+                logger.log("Manual " + std::to_string(i));
+            }
+            assert(!readable(logger.notify_fd()));
+            for (int i = 100; i < 400; i++) {
+                logger.log("Manual " + std::to_string(i));
+            }
+            assert(readable(logger.notify_fd()));
+
+            // A bounded drain that leaves the ring past the threshold re-signals
+            assert(logger.drain(50) == 50);
+            assert(readable(logger.notify_fd()));
+            // An expired deadline still makes progress: one batch
+            size_t written = logger.drain(SIZE_MAX, std::chrono::steady_clock::now());
+            assert(written > 0 && written < 350);
+            assert(logger.drain() == 350 - written);
+            assert(!readable(logger.notify_fd()));
+
+            for (int i = 400; i < 410; i++) {
+                logger.log("Manual " + std::to_string(i));
+            }
+            // Left for the destructor
+        }
+
+        std::ifstream in("test_manual.log");
+        std::string line;
+        int count = 0;
+        while (std::getline(in, line)) {
+            assert(line.find("] Manual " + std::to_string(count)) != std::string::npos);
+            count++;
+        }
+        assert(count == 410);
+    }
+
+    {
+        // Test 8: Several front-ends share one backend thread; none is starved
+        std::cout << "Test 8: Shared LogBackend\n";
+        const char* paths[] = {"test_backend_0.log", "test_backend_1.log", "test_backend_2.log"};
+        for (const char* path : paths) std::remove(path);
+        {
+            LogBackend backend(std::chrono::milliseconds(1));
+            LoggerOptions options;
+            options.backend = &backend;
+            {
+                Logger a(paths[0], options);
+                Logger b(paths[1], options);
+                assert(backend.logger_count() == 2);
+                {
+                    Logger c(paths[2], options);
+                    assert(backend.logger_count() == 3);
+                    std::vector<std::thread> producers;
+                    Logger* loggers[] = {&a, &b, &c};
+                    for (Logger* logger : loggers) {
+                        producers.emplace_back([logger]() {
+                            for (int i = 0; i < 3000; i++) {
+                                logger->log("Backend " + std::to_string(i));
+                                if (i % 500 == 499) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                            }
+                        });
+                    }
+                    for (auto& producer : producers) producer.join();
+                    assert(a.get_dropped_count() + b.get_dropped_count() + c.get_dropped_count() == 0);
+                }
+                assert(backend.logger_count() == 2);
+
+                // Remaining front-ends keep being serviced after one detaches
+                a.log("After detach");
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                std::ifstream in(paths[0]);
+                std::string line, last;
+                while (std::getline(in, line)) last = line;
+                assert(last.find("] After detach") != std::string::npos);
+            }
+            assert(backend.logger_count() == 0);
+        }
+
+        for (const char* path : paths) {
+            std::ifstream in(path);
+            std::string line;
+            int count = 0;
+            while (std::getline(in, line)) {
+                if (line.find("] Backend " + std::to_string(count)) != std::string::npos) count++;
+            }
+            assert(count == 3000);
+        }
+    }
+
     std::cout << "Logger destroyed, check test.log\n";
     std::cout << "✅ Test complete\n";
     
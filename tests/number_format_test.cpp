@@ -0,0 +1,197 @@
+#include <iostream>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include "../include/number_format.hpp"
+
+// Every kernel must produce exactly what std::to_chars produces.
+
+static std::string expect_uint(uint64_t v) {
+    char buf[32];
+    return std::string(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+}
+
+static std::string expect_int(int64_t v) {
+    char buf[32];
+    return std::string(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+}
+
+static std::string expect_double(double v) {
+    char buf[64];
+    return std::string(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+}
+
+static std::string expect_fixed(double v, int precision) {
+    char buf[FIXED_CHARS_MAX];
+    return std::string(buf, std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::fixed, precision).ptr);
+}
+
+static void check_uint(uint64_t v) {
+    char buf[NUMBER_CHARS_MAX];
+    std::string got(buf, format_uint(buf, v));
+    if (got != expect_uint(v)) {
+        std::cerr << "format_uint(" << v << ") = " << got << "\n";
+        assert(false);
+    }
+    assert(decimal_digits(v) == static_cast<int>(got.size()));
+}
+
+static void check_int(int64_t v) {
+    char buf[NUMBER_CHARS_MAX];
+    std::string got(buf, format_int(buf, v));
+    if (got != expect_int(v)) {
+        std::cerr << "format_int(" << v << ") = " << got << "\n";
+        assert(false);
+    }
+}
+
+static void check_double(double v) {
+    char buf[NUMBER_CHARS_MAX];
+    std::string got(buf, format_double(buf, v));
+    std::string want = expect_double(v);
+    if (got != want) {
+        std::cerr.precision(17);
+        std::cerr << "format_double(" << v << ") = " << got << ", to_chars = " << want << "\n";
+        assert(false);
+    }
+}
+
+static void check_fixed(double v, int precision) {
+    char buf[FIXED_CHARS_MAX];
+    std::string got(buf, format_fixed(buf, v, precision));
+    std::string want = expect_fixed(v, precision);
+    if (got != want) {
+        std::cerr.precision(17);
+        std::cerr << "format_fixed(" << v << ", " << precision << ") = " << got << ", to_chars = " << want << "\n";
+        assert(false);
+    }
+}
+
+static double from_bits(uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+void test_integers() {
+    // Exhaustive over the first ten million, then every digit-count boundary
+    for (uint64_t v = 0; v < 10000000; v++) {
+        check_uint(v);
+    }
+    uint64_t p = 1;
+    for (int k = 0; k < 20; k++, p *= 10) {
+        for (uint64_t v : {p - 1, p, p + 1}) {
+            check_uint(v);
+        }
+    }
+    for (int b = 0; b < 64; b++) {
+        uint64_t v = uint64_t(1) << b;
+        check_uint(v - 1);
+        check_uint(v);
+    }
+    check_uint(std::numeric_limits<uint64_t>::max());
+
+    check_int(0);
+    check_int(-1);
+    check_int(std::numeric_limits<int64_t>::min());
+    check_int(std::numeric_limits<int64_t>::max());
+
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 2000000; i++) {
+        uint64_t v = rng() >> (rng() % 64);     // spread over every magnitude
+        check_uint(v);
+        check_int(static_cast<int64_t>(i % 2 ? v : 0 - v));
+    }
+
+    std::cout << "✓ test_integers passed\n";
+}
+
+void test_doubles() {
+    for (double v : {0.0, -0.0, 1.0, -1.0, 0.1, 0.3, 101.25, 1e21, 1e22, 1e23, 123456789012345678.0,
+                     5e-324, 2.2250738585072014e-308, 2.2250738585072009e-308,
+                     std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+                     std::numeric_limits<double>::epsilon(), 9007199254740993.0, 0.000001, 1e-7}) {
+        check_double(v);
+        check_double(-v);
+    }
+
+    // Every binary exponent, including subnormals: both boundaries of the
+    // significand and a spread of random ones
+    std::mt19937_64 rng(7);
+    const uint64_t significand_mask = (uint64_t(1) << 52) - 1;
+    for (uint64_t e = 0; e < 2047; e++) {
+        check_double(from_bits(e << 52 | 0));
+        check_double(from_bits(e << 52 | 1));
+        check_double(from_bits(e << 52 | significand_mask));
+        for (int i = 0; i < 500; i++) {
+            check_double(from_bits(e << 52 | (rng() & significand_mask)));
+        }
+    }
+
+    // Powers of ten and their neighbours
+    for (int k = -323; k <= 308; k++) {
+        double v = std::strtod(("1e" + std::to_string(k)).c_str(), nullptr);
+        check_double(v);
+        check_double(std::nextafter(v, 0.0));
+        check_double(std::nextafter(v, INFINITY));
+    }
+
+    // Short decimals (prices, quantities) that the shortest form must recover
+    for (int i = 0; i < 200000; i++) {
+        check_double(static_cast<double>(rng() % 100000000) / 100.0);
+        check_double(static_cast<double>(rng() % 1000000) * 1e-6);
+    }
+
+    // Random bit patterns
+    for (int i = 0; i < 3000000; i++) {
+        double v = from_bits(rng());
+        if (std::isfinite(v)) {
+            check_double(v);
+        }
+    }
+
+    std::cout << "✓ test_doubles passed\n";
+}
+
+void test_fixed() {
+    // Exact binary ties round half to even; near-ties go by the exact value
+    for (double v : {0.125, 0.375, 2.5, 3.5, 1.005, 0.145, 101.255, -0.001, -0.0, 0.0, 1e-10}) {
+        for (int precision = 0; precision <= 9; precision++) {
+            check_fixed(v, precision);
+        }
+    }
+    // Large magnitudes take the fallback path
+    for (double v : {4503599627370496.0, 1e20, std::numeric_limits<double>::max(), -1e300}) {
+        check_fixed(v, 2);
+        check_fixed(v, 9);
+    }
+
+    std::mt19937_64 rng(11);
+    for (int i = 0; i < 1000000; i++) {
+        int precision = static_cast<int>(rng() % 10);
+        double ticks = static_cast<double>(rng() % 10000000);
+        check_fixed(ticks / 100.0, precision);                            // prices
+        check_fixed(ticks / 8.0 - 500000.0, precision);                   // exact binary ties
+        check_fixed(std::uniform_real_distribution<double>(-1e6, 1e6)(rng), precision);
+        check_fixed(std::ldexp(static_cast<double>(rng() >> 11), -static_cast<int>(rng() % 80)), precision);
+    }
+
+    std::cout << "✓ test_fixed passed\n";
+}
+
+int main() {
+    std::cout << "Running number format tests...\n\n";
+
+    test_integers();
+    test_doubles();
+    test_fixed();
+
+    std::cout << "\n✅ All number format tests passed!\n";
+    return 0;
+}
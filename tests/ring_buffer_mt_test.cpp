@@ -3,6 +3,7 @@
 #include <atomic>
 #include <vector>
 #include <cassert>
+#include <cstdint>
 #include "../include/ring_buffer.hpp"
 
 // Test: Producer pushes N items, consumer pops N items
@@ -139,12 +140,51 @@ void test_burst_workload() {
     std::cout << "✓ test_burst_workload passed\n";
 }
 
+// Test: Non-default policies under real concurrency (cached indices only
+// reload the other side's index on apparent full/empty, narrow indices wrap)
+template <typename Ring>
+void run_policy_spsc(const char* name) {
+    constexpr size_t NUM_ITEMS = 500000;
+    Ring rb;
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < NUM_ITEMS; i++) {
+            while (!rb.try_push(static_cast<int>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread consumer([&]() {
+        for (size_t i = 0; i < NUM_ITEMS; i++) {
+            int value;
+            while (!rb.try_pop(value)) {
+                std::this_thread::yield();
+            }
+            assert(value == static_cast<int>(i));
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    assert(rb.is_empty());
+
+    std::cout << "✓ test_policy_variants passed (" << name << ")\n";
+}
+
+void test_policy_variants() {
+    run_policy_spsc<RingBuffer<int, 1024, uint32_t, 128, AcquireRelease, true>>("u32/pad128/cached");
+    run_policy_spsc<RingBuffer<int, 16, uint16_t, 64, AcquireRelease, true>>("u16/pad64/cached");
+    run_policy_spsc<RingBuffer<int, 256, size_t, 64, SequentiallyConsistent, false>>("seq_cst");
+}
+
 int main() {
     std::cout << "Running multi-threaded RingBuffer tests...\n\n";
     
     test_spsc_correctness();
     test_high_contention();
     test_burst_workload();
+    test_policy_variants();
     
     std::cout << "\n✅ All multi-threaded tests passed!\n";
     std::cout << "Your SPSC RingBuffer is working correctly under concurrent access.\n";
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <cassert>
+#include <cstdint>
 #include "../include/ring_buffer.hpp"
 
 void test_basic_push_pop() {
@@ -78,6 +79,92 @@ void test_pop_empty() {
     std::cout << "✓ test_pop_empty passed\n";
 }
 
+void test_bulk_push() {
+    RingBuffer<int, 8> rb;
+    int items[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    assert(rb.try_push_bulk(items, 3) == 3);
+    assert(rb.size() == 3);
+
+    // Only the free slots are filled; the rest is left to the caller
+    assert(rb.try_push_bulk(items + 3, 7) == 4);
+    assert(rb.is_full());
+    assert(rb.try_push_bulk(items, 1) == 0);
+
+    for (int i = 0; i < 7; i++) {
+        int value;
+        assert(rb.try_pop(value));
+        assert(value == i);
+    }
+    assert(rb.is_empty());
+
+    // Wraps around the end of the storage
+    assert(rb.try_push_bulk(items, 6) == 6);
+    for (int i = 0; i < 6; i++) {
+        int value;
+        assert(rb.try_pop(value));
+        assert(value == i);
+    }
+
+    std::cout << "✓ test_bulk_push passed\n";
+}
+
+void test_narrow_index_wraparound() {
+    // 16-bit indices wrap after 65536 operations; push well past that
+    RingBuffer<int, 8, uint16_t> rb;
+    int items[5] = {0, 1, 2, 3, 4};
+
+    for (int round = 0; round < 40000; round++) {
+        assert(rb.try_push(round));
+        assert(rb.try_push_bulk(items, 5) == 5);
+        assert(rb.size() == 6);
+
+        int value;
+        assert(rb.try_pop(value));
+        assert(value == round);
+        for (int i = 0; i < 5; i++) {
+            assert(rb.try_pop(value));
+            assert(value == i);
+        }
+        assert(rb.is_empty());
+    }
+
+    std::cout << "✓ test_narrow_index_wraparound passed\n";
+}
+
+void test_cached_indices() {
+    RingBuffer<int, 8, uint32_t, 128, AcquireRelease, true> rb;
+    int items[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    // Full/empty must still be detected through the stale copies
+    for (int round = 0; round < 3; round++) {
+        assert(rb.try_push_bulk(items, 10) == 7);
+        assert(rb.is_full());
+        assert(!rb.try_push(999));
+
+        int value;
+        assert(rb.try_pop(value));
+        assert(value == 0);
+        assert(rb.try_push(999));           // reloads tail_ after the pop
+
+        for (int i = 1; i < 7; i++) {
+            assert(rb.try_pop(value));
+            assert(value == i);
+        }
+        assert(rb.try_pop(value));
+        assert(value == 999);
+        assert(!rb.try_pop(value));
+    }
+
+    RingBuffer<int, 8, size_t, 64, SequentiallyConsistent, true> seq;
+    int value;
+    assert(seq.try_push(7));
+    assert(seq.try_pop(value) && value == 7);
+    assert(!seq.try_pop(value));
+
+    std::cout << "✓ test_cached_indices passed\n";
+}
+
 int main() {
     std::cout << "Running RingBuffer tests...\n\n";
     
@@ -85,6 +172,9 @@ int main() {
     test_fill_buffer();
     test_wraparound();
     test_pop_empty();
+    test_bulk_push();
+    test_narrow_index_wraparound();
+    test_cached_indices();
     
     std::cout << "\n✅ All tests passed!\n";
     return 0;
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include "../include/logger.hpp"
+#include "../include/shm_ring.hpp"
+
+// This process's segments for `name`, in creation order.
+static std::vector<std::string> segments_for(const std::string& name) {
+    std::string prefix = SHM_RING_PREFIX + name + "." + std::to_string(::getpid()) + ".";
+    std::vector<std::string> found;
+    for (const std::string& segment : ShmRing::list()) {
+        if (segment.compare(0, prefix.size(), prefix) == 0) found.push_back(segment);
+    }
+    std::sort(found.begin(), found.end(), [](const std::string& a, const std::string& b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+    return found;
+}
+
+void test_logger_publishes_to_segment() {
+    std::string segment;
+    {
+        LoggerOptions options;
+        options.shared_memory = true;
+        Logger logger("shm_test", options);
+
+        auto segments = segments_for("shm_test");
+        assert(segments.size() == 1);
+        segment = segments[0];
+
+        logger.log("hello from producer");
+        logger.log_kv("fill", {{"px", 101.25}, {"qty", 300}});
+        std::string stack_trace(2000, 's');
+        logger.log(stack_trace);
+
+        // A consumer in another process would do exactly this
+        auto consumer = ShmRing::attach(segment);
+        assert(consumer->header().producer_pid == ::getpid());
+        assert(std::strcmp(consumer->header().name, "shm_test") == 0);
+        assert(consumer->producer_alive());
+
+        LogEntry entry;
+        assert(consumer->ring().try_pop(entry));
+        assert(std::string(entry.inline_data, entry.length) == "hello from producer");
+        assert(consumer->ring().try_pop(entry));
+        assert(entry.kind == EntryKind::KeyValue);
+
+        std::string out;
+        LogFormatter formatter(LogFormat::Text);
+        formatter.format(entry, consumer->pool().payload(entry), out);
+        assert(out.find("fill px=101.25 qty=300") != std::string::npos);
+
+        // Large payloads travel in a slab of the segment's pool
+        assert(consumer->ring().try_pop(entry));
+        assert(entry.slab != SLAB_NONE);
+        assert(std::string(consumer->pool().payload(entry), entry.length) == stack_trace);
+        consumer->pool().release(entry.slab);
+        assert(!consumer->ring().try_pop(entry));
+        assert(consumer->header().state.load() == static_cast<uint32_t>(ShmRingState::Live));
+    }
+
+    // Entries logged right before shutdown stay readable until the consumer unlinks
+    auto consumer = ShmRing::attach(segment);
+    assert(consumer->header().state.load() == static_cast<uint32_t>(ShmRingState::Closed));
+    consumer->unlink();
+
+    std::cout << "✓ test_logger_publishes_to_segment passed\n";
+}
+
+void test_rejects_incompatible_layout() {
+    auto producer = ShmRing::create("shm_version_test");
+    producer->header().version = SHM_RING_VERSION + 1;
+
+    bool threw = false;
+    try {
+        ShmRing::attach(producer->segment());
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    producer->unlink();
+
+    std::cout << "✓ test_rejects_incompatible_layout passed\n";
+}
+
+void test_rejects_writer_options() {
+    LoggerOptions options;
+    options.shared_memory = true;
+    options.compression = Compression::LZ4;
+    bool threw = false;
+    try {
+        Logger logger("shm_options_test", options);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(segments_for("shm_options_test").empty());
+
+    std::cout << "✓ test_rejects_writer_options passed\n";
+}
+
+void test_reopen_keeps_undrained_segment() {
+    LoggerOptions options;
+    options.shared_memory = true;
+    {
+        Logger first("shm_reopen", options);
+        first.log("from the first instance");
+    }
+    {
+        Logger second("shm_reopen", options);
+        second.log("from the second instance");
+    }
+
+    // Each instance got its own segment; the closed one was not recreated
+    auto segments = segments_for("shm_reopen");
+    assert(segments.size() == 2);
+    const char* expected[] = {"from the first instance", "from the second instance"};
+    for (size_t i = 0; i < 2; i++) {
+        auto consumer = ShmRing::attach(segments[i]);
+        LogEntry entry;
+        assert(consumer->ring().try_pop(entry));
+        assert(std::string(entry.inline_data, entry.length) == expected[i]);
+        consumer->unlink();
+    }
+    assert(segments_for("shm_reopen").empty());
+
+    std::cout << "✓ test_reopen_keeps_undrained_segment passed\n";
+}
+
+void test_single_consumer() {
+    auto producer = ShmRing::create("shm_consumer_test");
+    {
+        auto consumer = ShmRing::attach(producer->segment());
+        bool threw = false;
+        try {
+            ShmRing::attach(producer->segment());
+        } catch (const std::runtime_error& e) {
+            threw = std::strstr(e.what(), "already has a consumer") != nullptr;
+        }
+        assert(threw);
+    }
+    // The lock goes with the consumer
+    auto consumer = ShmRing::attach(producer->segment());
+    consumer->unlink();
+
+    std::cout << "✓ test_single_consumer passed\n";
+}
+
+int main() {
+    std::cout << "Running shared-memory ring tests...\n\n";
+
+    test_logger_publishes_to_segment();
+    test_rejects_incompatible_layout();
+    test_rejects_writer_options();
+    test_reopen_keeps_undrained_segment();
+    test_single_consumer();
+
+    std::cout << "\n✅ All shared-memory ring tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "../include/logger.hpp"
+#include "../include/slab_pool.hpp"
+
+void test_size_classes() {
+    std::unique_ptr<SlabPool> pool(new SlabPool());
+
+    uint32_t small = pool->acquire(100);
+    uint32_t medium = pool->acquire(300);
+    uint32_t largest = pool->acquire(SlabPool::max_size());
+    assert(small >> 24 == 0);
+    assert(medium >> 24 == 1);
+    assert(largest >> 24 == SLAB_CLASSES - 1);
+    assert(pool->acquire(SlabPool::max_size() + 1) == SLAB_NONE);
+    assert(pool->data(small) != pool->data(medium));
+
+    // An exhausted class falls through to the next larger one, then runs out
+    std::vector<uint32_t> taken;
+    for (uint32_t i = 0; i < SLAB_CLASS_COUNT[3]; i++) {
+        taken.push_back(pool->acquire(10000));
+        assert(taken.back() >> 24 == 3);
+    }
+    uint32_t spilled = pool->acquire(10000);
+    assert(spilled >> 24 == 4);
+    taken.push_back(spilled);
+    while (taken.size() < SLAB_CLASS_COUNT[3] + SLAB_CLASS_COUNT[4] - 1) {
+        taken.push_back(pool->acquire(10000));
+    }
+    assert(pool->acquire(10000) == SLAB_NONE);
+
+    for (uint32_t handle : taken) {
+        pool->release(handle);
+    }
+    pool->release(largest);
+    assert(pool->acquire(10000) >> 24 == 3);
+
+    std::cout << "✓ test_size_classes passed\n";
+}
+
+void test_concurrent_acquire_release() {
+    std::unique_ptr<SlabPool> pool(new SlabPool());
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+
+    // Each thread stamps the slabs it holds; a slab handed to two threads at once would be overwritten
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            uint32_t held[8];
+            for (int round = 0; round < 20000; round++) {
+                for (int i = 0; i < 8; i++) {
+                    held[i] = pool->acquire(200);
+                    assert(held[i] != SLAB_NONE);
+                    std::memset(pool->data(held[i]), 'a' + t, 200);
+                }
+                for (int i = 0; i < 8; i++) {
+                    const char* p = pool->data(held[i]);
+                    if (p[0] != 'a' + t || p[199] != 'a' + t) failed = true;
+                    pool->release(held[i]);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    assert(!failed);
+
+    // Everything came back
+    std::vector<uint32_t> all;
+    for (uint32_t i = 0; i < SLAB_CLASS_COUNT[0]; i++) {
+        all.push_back(pool->acquire(200));
+        assert(all.back() >> 24 == 0);
+    }
+
+    std::cout << "✓ test_concurrent_acquire_release passed\n";
+}
+
+void test_large_messages_through_logger() {
+    const char* path = "test_slab.log";
+    std::remove(path);
+
+    std::string fix_dump;
+    for (int i = 0; fix_dump.size() < 3000; i++) {
+        fix_dump += "8=FIX.4.4|35=8|11=" + std::to_string(i) + "|";
+    }
+    std::string huge(100000, 'z');
+    std::string blob(5000, 'b');
+    {
+        LoggerOptions options;
+        options.idle_sleep = std::chrono::microseconds(500);
+        Logger logger(path, options);
+        logger.log("short");
+        logger.log(fix_dump);
+        logger.log(huge);
+        logger.log_kv("trace", {{"frames", blob}, {"depth", 42}});
+
+        // Three times the 4 KiB class: only works if the consumer hands slabs back
+        for (int round = 0; round < 3; round++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            for (uint32_t i = 0; i < SLAB_CLASS_COUNT[2]; i++) {
+                logger.log(fix_dump);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(logger.get_dropped_count() == 0);
+    }
+
+    std::ifstream in(path);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(in, line)) {
+        lines.push_back(line.substr(line.find("] ") + 2));
+    }
+    assert(lines.size() == 4 + 3 * SLAB_CLASS_COUNT[2]);
+    assert(lines[0] == "short");
+    assert(lines[1] == fix_dump);                          // not truncated
+    assert(lines[2] == huge.substr(0, LOG_MAX_PAYLOAD));   // capped at the largest record
+    assert(lines[3] == "trace frames=" + blob + " depth=42");
+    assert(lines.back() == fix_dump);
+
+    std::cout << "✓ test_large_messages_through_logger passed\n";
+}
+
+int main() {
+    std::cout << "Running slab pool tests...\n\n";
+
+    test_size_classes();
+    test_concurrent_acquire_release();
+    test_large_messages_through_logger();
+
+    std::cout << "\n✅ All slab pool tests passed!\n";
+    return 0;
+}
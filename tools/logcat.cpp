@@ -0,0 +1,92 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../include/compression.hpp"
+#include "../include/log_format.hpp"
+
+// Streams log files to stdout. LZ4-framed files (Compression::LZ4) are
+// decompressed, binary-format streams (LogFormat::Binary) are rendered as
+// JSON lines, and plain text passes through unchanged.
+class Output {
+    public:
+        void write(const char* data, size_t size){
+            if (first_){
+                binary_ = size >= sizeof(BINARY_LOG_MAGIC) &&
+                          std::memcmp(data, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) == 0;
+                first_ = false;
+            }
+            if (!binary_){
+                std::cout.write(data, size);
+                return;
+            }
+
+            pending_.append(data, size);
+            size_t used = decoder_.decode(pending_.data(), pending_.size(), [this](const DecodedRecord& record){
+                line_.clear();
+                append_json_record(record, line_);
+                std::cout.write(line_.data(), line_.size());
+            });
+            pending_.erase(0, used);
+        }
+
+        bool truncated() const {return !pending_.empty();}
+
+    private:
+        bool first_ = true;
+        bool binary_ = false;
+        BinaryLogDecoder decoder_;
+        std::string pending_;
+        std::string line_;
+};
+
+static int cat_file(const char* path){
+    std::ifstream in(path, std::ios::binary);
+    if (!in){
+        std::cerr << "logcat: cannot open " << path << "\n";
+        return 1;
+    }
+
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.clear();
+    in.seekg(0);
+
+    Output output;
+    try {
+        if (magic == FRAME_MAGIC){
+            FrameHeader header;
+            std::string raw;
+            while (read_frame(in, header, raw)){
+                output.write(raw.data(), raw.size());
+            }
+        } else {
+            char chunk[64 * 1024];
+            while (in.read(chunk, sizeof(chunk)) || in.gcount() > 0){
+                output.write(chunk, in.gcount());
+            }
+        }
+    } catch (const std::exception& e){
+        std::cerr << "logcat: " << path << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    if (output.truncated()){
+        std::cerr << "logcat: " << path << ": truncated final record\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        std::cerr << "usage: logcat <file>...\n";
+        return 2;
+    }
+
+    std::ios::sync_with_stdio(false);
+    int status = 0;
+    for (int i = 1; i < argc; i++){
+        status |= cat_file(argv[i]);
+    }
+    return status;
+}
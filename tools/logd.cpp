@@ -0,0 +1,157 @@
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include "../include/log_format.hpp"
+#include "../include/shm_ring.hpp"
+
+// Out-of-process log writer. Attaches to every producer ring created with
+// LoggerOptions::shared_memory, drains them on one thread, and writes
+// <dir>/<segment>.log per producer. Segments are unlinked once their producer
+// has closed (or died) and the ring is empty, so a crashed producer's last
+// entries still reach disk. Each ring is locked to one logd while attached.
+//
+// usage: logd [--dir DIR] [--format text|json|binary] [--escape raw|text] [--poll-us N] [--once]
+
+static volatile std::sig_atomic_t stop_requested = 0;
+
+static void on_signal(int){
+    stop_requested = 1;
+}
+
+struct Producer {
+    std::unique_ptr<ShmRing> shm;
+    std::ofstream out;
+    LogFormatter formatter;
+    std::string pending;
+
+    Producer(std::unique_ptr<ShmRing> ring, const std::string& path, LogFormat format, EscapeMode escape)
+        : shm(std::move(ring)), out(path, std::ios::out | std::ios::app | std::ios::binary), formatter(format, escape){
+        formatter.begin(pending);
+    }
+
+    // Returns entries written.
+    size_t drain(size_t max_entries){
+        LogEntry entry;
+        size_t written = 0;
+        while (written < max_entries && shm->ring().try_pop(entry)){
+            formatter.format(entry, shm->pool().payload(entry), pending);
+            if (entry.slab != SLAB_NONE){
+                shm->pool().release(entry.slab);
+            }
+            written++;
+        }
+        if (!pending.empty()){
+            out.write(pending.data(), pending.size());
+            out.flush();
+            pending.clear();
+        }
+        return written;
+    }
+};
+
+int main(int argc, char** argv){
+    std::string dir = ".";
+    LogFormat format = LogFormat::Text;
+    EscapeMode escape = EscapeMode::Raw;
+    auto poll = std::chrono::microseconds(1000);
+    bool once = false;
+
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc){
+            dir = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc){
+            std::string f = argv[++i];
+            format = f == "json" ? LogFormat::Json : f == "binary" ? LogFormat::Binary : LogFormat::Text;
+        } else if (arg == "--escape" && i + 1 < argc){
+            escape = std::string(argv[++i]) == "text" ? EscapeMode::Text : EscapeMode::Raw;
+        } else if (arg == "--poll-us" && i + 1 < argc){
+            poll = std::chrono::microseconds(std::stoll(argv[++i]));
+        } else if (arg == "--once"){
+            once = true;   // drain what exists now, then exit
+        } else {
+            std::cerr << "usage: logd [--dir DIR] [--format text|json|binary] [--escape raw|text] [--poll-us N] [--once]\n";
+            return 2;
+        }
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    constexpr size_t BATCH_SIZE = 256;
+    const auto rescan_interval = std::chrono::milliseconds(100);
+    std::map<std::string, std::unique_ptr<Producer>> producers;
+    std::set<std::string> rejected;   // incompatible segments, reported once
+    auto next_scan = std::chrono::steady_clock::time_point{};
+
+    while (!stop_requested){
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_scan){
+            for (const std::string& segment : ShmRing::list()){
+                if (producers.count(segment) || rejected.count(segment)){
+                    continue;
+                }
+                try {
+                    auto shm = ShmRing::attach(segment);
+                    std::string path = dir + "/" + segment.substr(std::strlen(SHM_RING_PREFIX)) + ".log";
+                    producers[segment].reset(new Producer(std::move(shm), path, format, escape));
+                    std::cerr << "logd: attached " << segment << " -> " << path << "\n";
+                } catch (const std::exception& e){
+                    // Still being created (not yet sized, header not yet written)
+                    // or drained by another logd: retry on the next scan.
+                    // Anything else is reported once.
+                    if (std::strstr(e.what(), "being created") == nullptr &&
+                        std::strstr(e.what(), "too small") == nullptr &&
+                        std::strstr(e.what(), "Not a log ring") == nullptr &&
+                        std::strstr(e.what(), "already has a consumer") == nullptr){
+                        std::cerr << "logd: " << e.what() << "\n";
+                        rejected.insert(segment);
+                    }
+                }
+            }
+            next_scan = now + rescan_interval;
+        }
+
+        // Round-robin one batch per producer so a noisy process cannot starve the rest.
+        size_t total = 0;
+        for (auto it = producers.begin(); it != producers.end();){
+            Producer& p = *it->second;
+            bool closed = p.shm->header().state.load(std::memory_order_acquire) ==
+                          static_cast<uint32_t>(ShmRingState::Closed);
+            bool gone = closed || !p.shm->producer_alive();
+
+            size_t written = p.drain(BATCH_SIZE);
+            total += written;
+
+            if (gone && written == 0 && p.shm->ring().is_empty()){
+                uint64_t dropped = p.shm->header().dropped.load();
+                std::cerr << "logd: " << it->first << (closed ? " closed" : " producer died")
+                          << (dropped ? ", producer dropped " + std::to_string(dropped) + " entries" : "") << "\n";
+                p.shm->unlink();
+                it = producers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (total == 0){
+            if (once){
+                break;
+            }
+            std::this_thread::sleep_for(poll);
+        }
+    }
+
+    // Shutting down: write out everything still buffered, leave live segments for the next logd.
+    for (auto& p : producers){
+        while (p.second->drain(BATCH_SIZE) > 0) {}
+    }
+    return 0;
+}
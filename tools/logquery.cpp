@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/compression.hpp"
+#include "../include/log_format.hpp"
+#include "../include/log_index.hpp"
+
+// Prints every record with from <= timestamp <= to, using each file's ".idx"
+// sidecar to jump straight to the range. Files are visited in time order, so
+// rotated pieces (app.log.2 app.log.1 app.log) can be passed in any order.
+// Files without an index are scanned in full.
+
+constexpr uint64_t NS_PER_DAY = 86400ull * 1000000000ull;
+
+struct TimeArg {
+    uint64_t value;
+    bool time_of_day;   // HH:MM:SS[.fraction], resolved against each file's UTC date
+};
+
+static bool parse_time(const char* s, TimeArg& out){
+    unsigned h, m, sec;
+    int consumed = 0;
+    if (std::sscanf(s, "%u:%u:%u%n", &h, &m, &sec, &consumed) == 3){
+        uint64_t ns = ((h * 60ull + m) * 60ull + sec) * 1000000000ull;
+        const char* frac = s + consumed;
+        if (*frac == '.'){
+            uint64_t scale = 100000000;
+            for (frac++; *frac >= '0' && *frac <= '9' && scale > 0; frac++, scale /= 10){
+                ns += (*frac - '0') * scale;
+            }
+        }
+        out = {ns, true};
+        return true;
+    }
+
+    char* end = nullptr;
+    out = {std::strtoull(s, &end, 10), false};
+    return end && *end == '\0' && end != s;
+}
+
+static uint64_t resolve(const TimeArg& t, uint64_t reference_ts){
+    return t.time_of_day ? (reference_ts / NS_PER_DAY) * NS_PER_DAY + t.value : t.value;
+}
+
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const std::string& path){
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0){
+            throw std::runtime_error("cannot open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0){
+            size = st.st_size;
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            data = p == MAP_FAILED ? nullptr : static_cast<const char*>(p);
+        }
+        ::close(fd);
+        if (size > 0 && !data){
+            throw std::runtime_error("cannot map " + path);
+        }
+    }
+    ~MappedFile(){
+        if (data){
+            ::munmap(const_cast<char*>(data), size);
+        }
+    }
+};
+
+class RangePrinter {
+    public:
+        RangePrinter(uint64_t from, uint64_t to) : from_(from), to_(to) {}
+
+        // `data` starts at a stream start point (line, binary preamble or frame payload).
+        void print(const char* data, size_t size){
+            if (size >= sizeof(BINARY_LOG_MAGIC) && std::memcmp(data, BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC)) == 0){
+                print_binary(data, size);
+            } else {
+                print_lines(data, size);
+            }
+        }
+
+    private:
+        uint64_t from_;
+        uint64_t to_;
+        std::string line_;
+
+        bool in_range(uint64_t ts) const {return ts >= from_ && ts <= to_;}
+
+        void print_binary(const char* data, size_t size){
+            BinaryLogDecoder decoder;
+            decoder.decode(data, size, [this](const DecodedRecord& record){
+                if (in_range(record.timestamp)){
+                    line_.clear();
+                    append_json_record(record, line_);
+                    std::cout.write(line_.data(), line_.size());
+                }
+            });
+        }
+
+        // Text lines start "[ts]", JSON lines start {"ts":ts
+        void print_lines(const char* p, size_t size){
+            const char* end = p + size;
+            while (p < end){
+                const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+                const char* next = eol ? eol + 1 : end;
+
+                const char* digits = p;
+                if (*digits == '['){
+                    digits++;
+                } else if (end - digits > 6 && std::memcmp(digits, "{\"ts\":", 6) == 0){
+                    digits += 6;
+                }
+                uint64_t ts = 0;
+                bool any = false;
+                for (; digits < next && *digits >= '0' && *digits <= '9'; digits++){
+                    ts = ts * 10 + (*digits - '0');
+                    any = true;
+                }
+                if (any && in_range(ts)){
+                    std::cout.write(p, next - p);
+                }
+                p = next;
+            }
+        }
+};
+
+struct InputFile {
+    std::string path;
+    std::unique_ptr<LogIndexReader> index;
+    uint64_t first_ts;
+};
+
+static void query_file(const InputFile& file, const TimeArg& from_arg, const TimeArg& to_arg){
+    MappedFile log(file.path);
+    uint64_t from = resolve(from_arg, file.first_ts);
+    uint64_t to = resolve(to_arg, file.first_ts);
+
+    uint64_t begin = 0;
+    uint64_t stop = log.size;
+    if (file.index){
+        begin = std::min<uint64_t>(file.index->seek_offset(from), log.size);
+        stop = std::min<uint64_t>(file.index->stop_offset(to), log.size);
+    }
+    RangePrinter printer(from, to);
+
+    bool framed = file.index ? file.index->framed()
+                             : log.size >= 4 && std::memcmp(log.data, &FRAME_MAGIC, 4) == 0;
+    if (!framed){
+        if (stop > begin){
+            printer.print(log.data + begin, stop - begin);
+        }
+        return;
+    }
+
+    std::string raw;
+    for (uint64_t offset = begin; offset + sizeof(FrameHeader) <= stop;){
+        FrameHeader header;
+        std::memcpy(&header, log.data + offset, sizeof(header));
+        uint64_t payload = offset + sizeof(header);
+        if (header.magic != FRAME_MAGIC || payload + header.stored_size > log.size){
+            throw std::runtime_error(file.path + ": corrupt frame at offset " + std::to_string(offset));
+        }
+
+        if (header.last_timestamp >= from && header.first_timestamp <= to){
+            if (header.flags & FRAME_STORED){
+                printer.print(log.data + payload, header.stored_size);
+            } else {
+                raw.resize(header.raw_size);
+                long n = lz4_decompress_block(log.data + payload, header.stored_size, &raw[0], raw.size());
+                if (n != static_cast<long>(header.raw_size)){
+                    throw std::runtime_error(file.path + ": corrupt frame at offset " + std::to_string(offset));
+                }
+                printer.print(raw.data(), raw.size());
+            }
+        }
+        offset = payload + header.stored_size;
+    }
+}
+
+int main(int argc, char** argv){
+    TimeArg from, to;
+    if (argc < 4 || !parse_time(argv[1], from) || !parse_time(argv[2], to)){
+        std::cerr << "usage: logquery <from> <to> <file>...\n"
+                  << "  times are epoch nanoseconds or HH:MM:SS[.fraction] (UTC, on each file's date)\n";
+        return 2;
+    }
+
+    std::vector<InputFile> files;
+    for (int i = 3; i < argc; i++){
+        InputFile file{argv[i], nullptr, 0};
+        try {
+            file.index.reset(new LogIndexReader(index_path_for(file.path)));
+            if (file.index->size() > 0){
+                file.first_ts = (*file.index)[0].first_timestamp;
+            }
+        } catch (const std::exception&){
+            std::cerr << "logquery: no usable index for " << file.path << ", scanning whole file\n";
+            file.index.reset();
+        }
+        files.push_back(std::move(file));
+    }
+    std::stable_sort(files.begin(), files.end(), [](const InputFile& a, const InputFile& b){
+        return a.first_ts < b.first_ts;
+    });
+
+    std::ios::sync_with_stdio(false);
+    int status = 0;
+    for (const auto& file : files){
+        if (file.index && file.index->size() > 0 && file.first_ts > resolve(to, file.first_ts)){
+            continue;   // whole file is newer than the range
+        }
+        if (!file.index && (from.time_of_day || to.time_of_day)){
+            std::cerr << "logquery: " << file.path << ": time-of-day ranges need an index, use epoch nanoseconds\n";
+            status = 1;
+            continue;
+        }
+        try {
+            query_file(file, from, to);
+        } catch (const std::exception& e){
+            std::cerr << "logquery: " << e.what() << "\n";
+            status = 1;
+        }
+    }
+    return status;
+}